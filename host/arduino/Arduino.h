@@ -0,0 +1,101 @@
+//
+// Simulated Arduino core for host builds.
+//
+// Mirrors the subset of the AVR core used by the controller, backed by the
+// virtual clock and pin models in SimCore.h instead of real hardware.
+//
+
+#ifndef Arduino_h
+#define Arduino_h
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <type_traits>
+
+#include "binary.h"
+#include "avr/io.h"
+#include "avr/interrupt.h"
+#include "avr/pgmspace.h"
+
+typedef uint8_t byte;
+typedef bool boolean;
+typedef unsigned int word;
+
+#define HIGH 0x1
+#define LOW  0x0
+
+#define INPUT 0x0
+#define OUTPUT 0x1
+#define INPUT_PULLUP 0x2
+
+// ATmega328 (Uno) pin numbering
+#define NUM_DIGITAL_PINS 20
+#define A0 14
+#define A1 15
+#define A2 16
+#define A3 17
+#define A4 18
+#define A5 19
+
+#define bit(b) (1UL << (b))
+#define bitRead(value, bit) (((value) >> (bit)) & 0x01)
+#define bitSet(value, bit) ((value) |= (1UL << (bit)))
+#define bitClear(value, bit) ((value) &= ~(1UL << (bit)))
+#define bitWrite(value, bit, bitvalue) ((bitvalue) ? bitSet(value, bit) : bitClear(value, bit))
+#define lowByte(w) ((uint8_t) ((w) & 0xff))
+#define highByte(w) ((uint8_t) ((w) >> 8))
+
+// The AVR core defines these as macros, templates keep <algorithm> usable.
+// common_type, not decltype(a < b ? a : b): for two arguments of the same
+// type that is a reference to a parameter.
+template<class T, class U>
+inline typename std::common_type<T, U>::type min(T a, U b) { return a < b ? a : b; }
+
+template<class T, class U>
+inline typename std::common_type<T, U>::type max(T a, U b) { return a > b ? a : b; }
+
+template<class T, class L, class H>
+inline T constrain(T amt, L low, H high) {
+    return amt < low ? (T) low : (amt > high ? (T) high : amt);
+}
+
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t val);
+int digitalRead(uint8_t pin);
+int analogRead(uint8_t pin);
+
+unsigned long millis(void);
+unsigned long micros(void);
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+// Busy waits call it, on the host it moves the clock to the next interrupt
+void yield(void);
+
+void noInterrupts(void);
+void interrupts(void);
+#define cli() noInterrupts()
+#define sei() interrupts()
+
+#ifdef __cplusplus
+// Only the global interrupt flag of the status register, so code can save
+// SREG, turn interrupts off and put the old state back like on the AVR
+#define SREG_I 7
+class StatusRegister {
+public:
+    operator uint8_t() const;
+    StatusRegister &operator=(uint8_t value);
+};
+extern StatusRegister SREG;
+#endif
+
+void setup(void);
+void loop(void);
+
+#ifdef __cplusplus
+#include "WString.h"
+#include "HardwareSerial.h"
+#endif
+
+#endif
@@ -0,0 +1,42 @@
+//
+// EEPROM for host builds, with the read/write/update/get/put subset of the
+// AVR library. The cells live in SimCore, so they survive sim::reset() like
+// the real ones survive a power cycle, and every byte written costs the
+// 3.4 ms the ATmega328 takes to program it.
+//
+
+#ifndef EEPROM_h
+#define EEPROM_h
+
+#include <inttypes.h>
+
+#include "SimCore.h"
+
+class EEPROMClass {
+public:
+    uint8_t read(int idx) { return sim::eepromRead(idx); }
+    void write(int idx, uint8_t val) { sim::eepromWrite(idx, val); }
+    void update(int idx, uint8_t val) {
+        if (read(idx) != val)
+            write(idx, val);
+    }
+    uint16_t length() { return sim::eepromSize; }
+
+    template<typename T> T &get(int idx, T &t) {
+        uint8_t *ptr = (uint8_t *) &t;
+        for (int count = sizeof(T); count; --count, ++idx)
+            *ptr++ = read(idx);
+        return t;
+    }
+
+    template<typename T> const T &put(int idx, const T &t) {
+        const uint8_t *ptr = (const uint8_t *) &t;
+        for (int count = sizeof(T); count; --count, ++idx)
+            update(idx, *ptr++);
+        return t;
+    }
+};
+
+static EEPROMClass EEPROM;
+
+#endif
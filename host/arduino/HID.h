@@ -0,0 +1,10 @@
+//
+// Only pulled in for the Arduino types, the host build has no USB HID.
+//
+
+#ifndef HID_h
+#define HID_h
+
+#include <Arduino.h>
+
+#endif
@@ -0,0 +1,28 @@
+//
+// Serial port for host builds. Output goes to the simulator's serial sink
+// (stdout by default), input is whatever the simulator queued.
+//
+
+#ifndef HardwareSerial_h
+#define HardwareSerial_h
+
+#include <inttypes.h>
+
+#include "Print.h"
+
+class HardwareSerial : public Print {
+public:
+    void begin(unsigned long baud) { (void) baud; }
+    void end() {}
+    int available(void);
+    int peek(void);
+    int read(void);
+    void flush(void) {}
+    virtual size_t write(uint8_t);
+    using Print::write;
+    operator bool() { return true; }
+};
+
+extern HardwareSerial Serial;
+
+#endif
@@ -0,0 +1,559 @@
+//
+// Virtual hardware behind the host Arduino core. Zero initialised state is
+// the power-on state, so global constructors may already touch the pins.
+//
+
+#include <stdio.h>
+#include <string.h>
+#include <deque>
+#include <vector>
+
+#include <Arduino.h>
+#include <avr/sleep.h>
+#include <avr/wdt.h>
+#include "SimCore.h"
+
+// Time a blocking analogRead() takes: 13 ADC clocks at 125 kHz plus setup
+#define ANALOG_READ_US 112
+// Erase and write of one EEPROM byte
+#define EEPROM_WRITE_US 3400
+// USART0 pins
+#define USART_RXD 0
+#define USART_TXD 1
+
+// Vectors without a handler are 0, like __bad_interrupt on the AVR without the reset
+extern "C" void TIMER1_COMPA_vect(void) __attribute__ ((weak));
+extern "C" void USART_RX_vect(void) __attribute__ ((weak));
+
+
+namespace {
+
+    struct Pin {
+        bool output;
+        bool latch;
+        bool driven;
+        bool external;
+        uint16_t analog;
+        sim::PinDevice *device;
+    };
+
+    uint64_t clockUs;
+    uint64_t nextInputChange;
+    Pin pins[NUM_DIGITAL_PINS];
+    std::vector<sim::PinObserver *> observers;
+    sim::I2cDevice *i2cDevices[128];
+    sim::SerialSink serialSink;
+    std::deque<uint8_t> serialInput;
+
+    uint8_t eepromCells[sim::eepromSize];
+    bool eepromErased = false;
+    unsigned long eepromWriteCount;
+
+    uint8_t sleepMode;
+    uint64_t watchdogUs;
+    uint64_t watchdogStart;
+
+    bool interruptsOff;
+    uint64_t interruptsOffSince;
+    uint64_t interruptsOffMax;
+    bool inInterrupt;
+
+    uint8_t usartReceived;
+    bool usartPending;
+
+    // Timer1 counted timer1Counts at timer1Since, timer1Match is when it
+    // next equals OCR1A, UINT64_MAX while it is stopped
+    uint8_t timer1Control;
+    uint16_t timer1Compare;
+    uint8_t timer1Flags;
+    uint64_t timer1Since;
+    uint64_t timer1Counts;
+    uint64_t timer1Match;
+
+    Pin *pinAt(uint8_t pin) {
+        return pin < NUM_DIGITAL_PINS ? &pins[pin] : NULL;
+    }
+
+    void notifyOutput(uint8_t pin, bool level) {
+        for (size_t i = 0; i < observers.size(); i++)
+            observers[i]->outputChanged(pin, level);
+    }
+
+    void update(uint8_t pin, bool output, bool latch) {
+        Pin *p = pinAt(pin);
+        if (!p)
+            return;
+
+        bool wasDriven = p->output;
+        bool oldLevel = p->latch;
+        p->output = output;
+        p->latch = latch;
+
+        if (p->device && (wasDriven != output || oldLevel != latch))
+            p->device->pinChanged(pin, output, latch);
+        if (output && (!wasDriven || oldLevel != latch))
+            notifyOutput(pin, latch);
+    }
+
+    // Timer1 clocks per second, 0 when stopped
+    uint32_t timer1Hz() {
+        static const uint16_t prescale[] = {0, 1, 8, 64, 256, 1024, 0, 0};
+        uint16_t divider = prescale[timer1Control & 0x07];
+        return divider ? F_CPU / divider : 0;
+    }
+
+    uint64_t timer1Count() {
+        uint32_t hz = timer1Hz();
+        return hz ? timer1Counts + (clockUs - timer1Since) * hz / 1000000 : timer1Counts;
+    }
+
+    // From a new count or prescaler: when the counter next equals OCR1A,
+    // a full turn later when it does now
+    void timer1Schedule() {
+        timer1Counts = timer1Count();
+        timer1Since = clockUs;
+        uint32_t hz = timer1Hz();
+        if (!hz) {
+            timer1Match = UINT64_MAX;
+            return;
+        }
+        uint32_t ahead = (uint16_t) (timer1Compare - (uint16_t) timer1Counts);
+        if (!ahead)
+            ahead = 0x10000;
+        timer1Match = clockUs + (ahead * (uint64_t) 1000000 + hz - 1) / hz;
+    }
+
+    // Runs the pending interrupts once they are enabled, in the AVR's
+    // vector order. A handler that starts the next frame or compare is not
+    // entered again from inside, the loop picks its interrupt up after it
+    // returns.
+    void runInterrupts() {
+        while (!interruptsOff && !inInterrupt) {
+            void (*vector)(void);
+            if ((timer1Flags & TIMSK1 & _BV(OCF1A)) && TIMER1_COMPA_vect) {
+                timer1Flags &= ~_BV(OCF1A);
+                vector = TIMER1_COMPA_vect;
+            } else if (usartPending && USART_RX_vect) {
+                usartPending = false;
+                vector = USART_RX_vect;
+            } else {
+                return;
+            }
+            inInterrupt = true;
+            noInterrupts();
+            vector();
+            interrupts();
+            inInterrupt = false;
+        }
+    }
+
+    // The CPU runs for 'us'. A compare match on the way sets OCF1A and,
+    // with interrupts on, runs the handler there; the time it takes comes
+    // on top, as a busy wait on the AVR is stretched by the interrupts.
+    void elapse(uint64_t us) {
+        uint64_t end = clockUs + us;
+        while (timer1Match <= end) {
+            if (timer1Match > clockUs)
+                clockUs = timer1Match;
+            uint64_t left = end - clockUs;
+            timer1Flags |= _BV(OCF1A);
+            timer1Schedule();
+            runInterrupts();
+            end = clockUs + left;
+        }
+        clockUs = end;
+    }
+
+}
+
+
+namespace sim {
+
+    uint64_t now() {
+        return clockUs;
+    }
+
+    void advance(uint64_t us) {
+        elapse(us);
+    }
+
+    void reset() {
+        clockUs = 0;
+        nextInputChange = UINT64_MAX;
+        for (uint8_t i = 0; i < NUM_DIGITAL_PINS; i++) {
+            pins[i].output = false;
+            pins[i].latch = false;
+            pins[i].driven = false;
+            pins[i].external = false;
+            pins[i].analog = 0;
+            pins[i].device = NULL;
+        }
+        observers.clear();
+        for (size_t i = 0; i < sizeof(i2cDevices) / sizeof(i2cDevices[0]); i++)
+            i2cDevices[i] = NULL;
+        serialSink = NULL;
+        serialInput.clear();
+        interruptsOff = false;
+        interruptsOffMax = 0;
+        inInterrupt = false;
+        UBRR0 = 0;
+        UCSR0A = 0;
+        UCSR0B = 0;
+        UCSR0C = 0;
+        usartReceived = 0;
+        usartPending = false;
+        TCCR1A = 0;
+        TIMSK1 = 0;
+        timer1Control = 0;
+        timer1Compare = 0;
+        timer1Flags = 0;
+        timer1Since = 0;
+        timer1Counts = 0;
+        timer1Match = UINT64_MAX;
+    }
+
+    void setNextInputChange(uint64_t us) {
+        nextInputChange = us;
+    }
+
+    uint64_t sleep(uint64_t us) {
+        for (size_t i = 0; i < observers.size(); i++)
+            observers[i]->sleeping();
+
+        // A change that is due but not applied yet, because the program
+        // kept the simulator waiting, is a pending interrupt: no sleep.
+        // 0 is none, like at power-on.
+        uint64_t wake = clockUs + us;
+        if (nextInputChange && nextInputChange < wake)
+            wake = nextInputChange > clockUs ? nextInputChange : clockUs;
+        uint64_t slept = wake - clockUs;
+        clockUs = wake;
+        return slept;
+    }
+
+    void attach(uint8_t pin, PinDevice *device) {
+        Pin *p = pinAt(pin);
+        if (p)
+            p->device = device;
+    }
+
+    void addObserver(PinObserver *observer) {
+        observers.push_back(observer);
+    }
+
+    void attachI2c(uint8_t address, I2cDevice *device) {
+        i2cDevices[address & 0x7F] = device;
+    }
+
+    I2cDevice *i2cDevice(uint8_t address) {
+        return i2cDevices[address & 0x7F];
+    }
+
+    void setInput(uint8_t pin, int level) {
+        Pin *p = pinAt(pin);
+        if (p) {
+            p->driven = level >= 0;
+            p->external = level > 0;
+        }
+    }
+
+    void setAnalog(uint8_t pin, uint16_t value) {
+        Pin *p = pinAt(pin < A0 ? pin + A0 : pin);
+        if (p)
+            p->analog = value > 1023 ? 1023 : value;
+    }
+
+    bool isOutput(uint8_t pin) {
+        Pin *p = pinAt(pin);
+        return p && p->output;
+    }
+
+    bool outputLevel(uint8_t pin) {
+        Pin *p = pinAt(pin);
+        return p && p->output && p->latch;
+    }
+
+    void setSerialSink(SerialSink sink) {
+        serialSink = sink;
+    }
+
+    void queueSerialInput(const char *text) {
+        while (*text)
+            serialInput.push_back((uint8_t) *text++);
+    }
+
+    uint64_t maxInterruptsOffUs() {
+        return interruptsOffMax;
+    }
+
+    uint8_t *eeprom() {
+        if (!eepromErased) {
+            memset(eepromCells, 0xFF, sizeof(eepromCells));
+            eepromErased = true;
+        }
+        return eepromCells;
+    }
+
+    uint8_t eepromRead(int address) {
+        return eeprom()[address & (eepromSize - 1)];
+    }
+
+    void eepromWrite(int address, uint8_t value) {
+        eeprom()[address & (eepromSize - 1)] = value;
+        eepromWriteCount++;
+        elapse(EEPROM_WRITE_US);
+    }
+
+    unsigned long eepromWrites() {
+        return eepromWriteCount;
+    }
+
+}
+
+
+void pinMode(uint8_t pin, uint8_t mode) {
+    Pin *p = pinAt(pin);
+    if (!p)
+        return;
+
+    if (mode == OUTPUT)
+        update(pin, true, p->latch);
+    else
+        update(pin, false, mode == INPUT_PULLUP);
+}
+
+void digitalWrite(uint8_t pin, uint8_t val) {
+    Pin *p = pinAt(pin);
+    if (p)
+        update(pin, p->output, val != LOW);
+}
+
+int digitalRead(uint8_t pin) {
+    Pin *p = pinAt(pin);
+    if (!p)
+        return LOW;
+    if (p->output)
+        return p->latch ? HIGH : LOW;
+
+    if (p->device) {
+        int level = p->device->pinLevel(pin);
+        if (level >= 0)
+            return level ? HIGH : LOW;
+    }
+    if (p->driven)
+        return p->external ? HIGH : LOW;
+
+    // Pull-up enabled through the output latch, otherwise the pin floats low
+    return p->latch ? HIGH : LOW;
+}
+
+int analogRead(uint8_t pin) {
+    Pin *p = pinAt(pin < A0 ? pin + A0 : pin);
+    elapse(ANALOG_READ_US);
+    return p ? p->analog : 0;
+}
+
+unsigned long millis(void) {
+    return (unsigned long) (clockUs / 1000);
+}
+
+unsigned long micros(void) {
+    return (unsigned long) clockUs;
+}
+
+void delay(unsigned long ms) {
+    elapse((uint64_t) ms * 1000);
+}
+
+void delayMicroseconds(unsigned int us) {
+    elapse(us);
+}
+
+void yield(void) {
+    /* Called from busy waits: nothing happens before the next interrupt */
+    if (!interruptsOff && (TIMSK1 & _BV(OCIE1A)) && timer1Match > clockUs)
+        elapse(timer1Match - clockUs);
+    else
+        elapse(1);
+}
+
+void noInterrupts(void) {
+    if (!interruptsOff) {
+        interruptsOff = true;
+        interruptsOffSince = clockUs;
+    }
+}
+
+void interrupts(void) {
+    if (interruptsOff) {
+        interruptsOff = false;
+        if (clockUs - interruptsOffSince > interruptsOffMax)
+            interruptsOffMax = clockUs - interruptsOffSince;
+    }
+    runInterrupts();
+}
+
+void set_sleep_mode(uint8_t mode) {
+    sleepMode = mode;
+}
+
+void sleep_cpu(void) {
+    if (sleepMode == SLEEP_MODE_IDLE) {
+        // Timer1 keeps running in idle, its compare interrupt wakes the CPU
+        elapse(0);
+        uint64_t wake = 1000 - clockUs % 1000;
+        if ((TIMSK1 & _BV(OCIE1A)) && timer1Match - clockUs < wake)
+            wake = timer1Match - clockUs;
+        sim::sleep(wake);
+        elapse(0);
+    } else if (!watchdogUs)
+        sim::sleep(UINT64_MAX - clockUs);
+    else if (watchdogStart + watchdogUs > clockUs)
+        sim::sleep(watchdogStart + watchdogUs - clockUs);
+}
+
+void wdt_enable(uint8_t timeout) {
+    /* The nominal times, the real oscillator is off by up to 10% */
+    static const uint16_t timeoutMs[] = {15, 30, 60, 120, 250, 500, 1000, 2000, 4000, 8000};
+    watchdogUs = timeout <= WDTO_8S ? timeoutMs[timeout] * (uint64_t) 1000 : 0;
+    watchdogStart = clockUs;
+}
+
+void wdt_disable(void) {
+    watchdogUs = 0;
+}
+
+void wdt_reset(void) {
+    watchdogStart = clockUs;
+}
+
+
+StatusRegister SREG;
+
+StatusRegister::operator uint8_t() const {
+    return interruptsOff ? 0 : bit(SREG_I);
+}
+
+StatusRegister &StatusRegister::operator=(uint8_t value) {
+    if (value & bit(SREG_I))
+        interrupts();
+    else
+        noInterrupts();
+    return *this;
+}
+
+
+volatile uint8_t TCCR1A;
+volatile uint8_t TIMSK1;
+Timer1Register TCCR1B(Timer1Register::CONTROL_B);
+Timer1Register TCNT1(Timer1Register::COUNTER);
+Timer1Register OCR1A(Timer1Register::COMPARE_A);
+Timer1Register TIFR1(Timer1Register::FLAGS);
+
+Timer1Register::operator uint16_t() const {
+    elapse(0);
+    switch (name) {
+        case CONTROL_B:
+            return timer1Control;
+        case COUNTER:
+            return (uint16_t) timer1Count();
+        case COMPARE_A:
+            return timer1Compare;
+        default:
+            return timer1Flags;
+    }
+}
+
+Timer1Register &Timer1Register::operator=(uint16_t value) {
+    elapse(0);
+    switch (name) {
+        case CONTROL_B:
+            timer1Counts = timer1Count();
+            timer1Since = clockUs;
+            timer1Control = (uint8_t) value;
+            break;
+        case COUNTER:
+            timer1Counts = value;
+            timer1Since = clockUs;
+            break;
+        case COMPARE_A:
+            timer1Compare = value;
+            break;
+        default:
+            timer1Flags &= ~value;
+            return *this;
+    }
+    timer1Schedule();
+    return *this;
+}
+
+
+volatile uint16_t UBRR0;
+volatile uint8_t UCSR0A;
+volatile uint8_t UCSR0B;
+volatile uint8_t UCSR0C;
+UsartDataRegister UDR0;
+
+UsartDataRegister::operator uint8_t() const {
+    UCSR0A &= ~(_BV(RXC0) | _BV(FE0));
+    return usartReceived;
+}
+
+UsartDataRegister &UsartDataRegister::operator=(uint8_t value) {
+    if (!(UCSR0B & _BV(TXEN0)))
+        return *this;
+
+    /* 8N1, LSB first. The frame is shifted out at once on the virtual
+       clock; the shift register does not need the CPU, so the time does
+       not count as interrupts held off. */
+    uint64_t bitNs = (uint64_t) (UBRR0 + 1) * (UCSR0A & _BV(U2X0) ? 8 : 16) * 1000000000 / F_CPU;
+    uint16_t frame = (uint16_t) (value << 1) | 0x200;
+    uint16_t echo = 0;
+    uint64_t start = clockUs;
+    for (uint8_t i = 0; i < 10; i++) {
+        clockUs = start + i * bitNs / 1000;
+        update(USART_TXD, true, frame & bit(i));
+        clockUs = start + (2 * i + 1) * bitNs / 2000;
+        if (digitalRead(USART_RXD))
+            echo |= bit(i);
+    }
+    clockUs = start + 10 * bitNs / 1000;
+    if (interruptsOff)
+        interruptsOffSince += clockUs - start;
+
+    if (UCSR0B & _BV(RXEN0)) {
+        /* A low stop bit is a framing error */
+        usartReceived = (uint8_t) (echo >> 1);
+        UCSR0A = (uint8_t) ((UCSR0A & ~_BV(FE0)) | _BV(RXC0) | (echo & 0x200 ? 0 : _BV(FE0)));
+        usartPending = UCSR0B & _BV(RXCIE0);
+        runInterrupts();
+    }
+    return *this;
+}
+
+
+HardwareSerial Serial;
+
+int HardwareSerial::available(void) {
+    return (int) serialInput.size();
+}
+
+int HardwareSerial::peek(void) {
+    return serialInput.empty() ? -1 : serialInput.front();
+}
+
+int HardwareSerial::read(void) {
+    if (serialInput.empty())
+        return -1;
+    uint8_t c = serialInput.front();
+    serialInput.pop_front();
+    return c;
+}
+
+size_t HardwareSerial::write(uint8_t c) {
+    if (serialSink)
+        serialSink(c);
+    else
+        putchar(c);
+    return 1;
+}
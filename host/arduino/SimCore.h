@@ -0,0 +1,87 @@
+//
+// Virtual hardware behind the host Arduino core: a microsecond clock that
+// only moves when the program waits or the simulator advances it, pin and
+// ADC state, and hooks for the device models on GPIO and I2C.
+//
+
+#ifndef SIM_CORE_H
+#define SIM_CORE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace sim {
+
+    // Virtual time in microseconds since reset()
+    uint64_t now();
+    void advance(uint64_t us);
+
+    // Back to power-on state: time zero, all pins inputs, no devices
+    void reset();
+
+    // When the simulator next changes an input. A sleeping CPU wakes there,
+    // as if every input change raised an interrupt, or at once when that
+    // time has already passed.
+    void setNextInputChange(uint64_t us);
+    // Sleeps up to 'us' of virtual time and returns the time slept
+    uint64_t sleep(uint64_t us);
+
+    // A model connected to one or more pins, e.g. a 1-Wire bus or a switch matrix
+    class PinDevice {
+    public:
+        virtual ~PinDevice() {}
+
+        // The MCU changed the mode or output latch of an attached pin
+        virtual void pinChanged(uint8_t pin, bool output, bool level) {
+            (void) pin; (void) output; (void) level;
+        }
+
+        // Level the device forces on the pin, or -1 if it does not drive it
+        virtual int pinLevel(uint8_t pin) = 0;
+    };
+
+    // Gets told about every output level change, used for traces
+    class PinObserver {
+    public:
+        virtual ~PinObserver() {}
+        virtual void outputChanged(uint8_t pin, bool level) = 0;
+        // Before the CPU sleeps, to catch up on changes that are not pin levels
+        virtual void sleeping() {}
+    };
+
+    class I2cDevice {
+    public:
+        virtual ~I2cDevice() {}
+        virtual void receive(const uint8_t *data, size_t length) = 0;
+    };
+
+    void attach(uint8_t pin, PinDevice *device);
+    void addObserver(PinObserver *observer);
+    void attachI2c(uint8_t address, I2cDevice *device);
+    I2cDevice *i2cDevice(uint8_t address);
+
+    // Level of an input pin that is driven from outside, -1 to let it float
+    void setInput(uint8_t pin, int level);
+    void setAnalog(uint8_t pin, uint16_t value);
+
+    bool isOutput(uint8_t pin);
+    bool outputLevel(uint8_t pin);
+
+    // Serial output is written to stdout unless a sink is set
+    typedef void (*SerialSink)(uint8_t c);
+    void setSerialSink(SerialSink sink);
+    void queueSerialInput(const char *text);
+
+    // Longest stretch spent between noInterrupts() and interrupts()
+    uint64_t maxInterruptsOffUs();
+
+    // EEPROM cells, erased (0xFF) at start and kept over reset()
+    const uint16_t eepromSize = 1024;
+    uint8_t eepromRead(int address);
+    void eepromWrite(int address, uint8_t value);
+    uint8_t *eeprom();
+    unsigned long eepromWrites();
+
+}
+
+#endif
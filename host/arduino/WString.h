@@ -0,0 +1,40 @@
+//
+// Minimal Arduino String for host builds.
+//
+
+#ifndef String_class_h
+#define String_class_h
+
+#include <string>
+
+class __FlashStringHelper;
+#define F(string_literal) (reinterpret_cast<const __FlashStringHelper *>(string_literal))
+
+class String {
+public:
+    String(const char *cstr = "") : buffer(cstr ? cstr : "") {}
+    String(char c) : buffer(1, c) {}
+    String(int value) : buffer(std::to_string(value)) {}
+    String(unsigned int value) : buffer(std::to_string(value)) {}
+    String(long value) : buffer(std::to_string(value)) {}
+    String(unsigned long value) : buffer(std::to_string(value)) {}
+
+    const char *c_str() const { return buffer.c_str(); }
+    unsigned int length() const { return (unsigned int) buffer.size(); }
+    char charAt(unsigned int index) const { return index < buffer.size() ? buffer[index] : 0; }
+    char operator[](unsigned int index) const { return charAt(index); }
+
+    String &operator+=(const String &rhs) { buffer += rhs.buffer; return *this; }
+    String &operator+=(const char *rhs) { buffer += rhs; return *this; }
+    String &operator+=(char rhs) { buffer += rhs; return *this; }
+
+    bool operator==(const String &rhs) const { return buffer == rhs.buffer; }
+    bool operator!=(const String &rhs) const { return buffer != rhs.buffer; }
+
+private:
+    std::string buffer;
+};
+
+inline String operator+(String lhs, const String &rhs) { return lhs += rhs; }
+
+#endif
@@ -0,0 +1,63 @@
+//
+// I2C master for host builds.
+//
+
+#include <Arduino.h>
+#include <Wire.h>
+#include "SimCore.h"
+
+// start condition, address byte and stop condition around the payload
+#define I2C_FRAME_BITS 20
+#define I2C_BITS_PER_BYTE 9
+
+
+TwoWire::TwoWire()
+: txAddress(0), txLength(0), transmitting(false), clockHz(100000) {
+}
+
+void TwoWire::begin() {
+    txLength = 0;
+    transmitting = false;
+}
+
+void TwoWire::beginTransmission(uint8_t address) {
+    txAddress = address;
+    txLength = 0;
+    transmitting = true;
+}
+
+uint8_t TwoWire::endTransmission(uint8_t sendStop) {
+    (void) sendStop;
+    transmitting = false;
+
+    uint64_t bits = I2C_FRAME_BITS + (uint64_t) txLength * I2C_BITS_PER_BYTE;
+    sim::advance((bits * 1000000 + clockHz - 1) / clockHz);
+
+    sim::I2cDevice *device = sim::i2cDevice(txAddress);
+    if (!device)
+        return 2;   // address sent, NACK received
+    device->receive(txBuffer, txLength);
+    return 0;
+}
+
+uint8_t TwoWire::requestFrom(uint8_t address, uint8_t quantity) {
+    (void) address;
+    (void) quantity;
+    return 0;
+}
+
+size_t TwoWire::write(uint8_t data) {
+    if (!transmitting || txLength >= BUFFER_LENGTH)
+        return 0;
+    txBuffer[txLength++] = data;
+    return 1;
+}
+
+size_t TwoWire::write(const uint8_t *data, size_t quantity) {
+    size_t n = 0;
+    while (n < quantity && write(data[n]))
+        n++;
+    return n;
+}
+
+TwoWire Wire;
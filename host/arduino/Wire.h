@@ -0,0 +1,42 @@
+//
+// I2C master for host builds. Transmissions are delivered to the simulated
+// device registered for the slave address and take the time the bytes
+// would need on a 100 kHz bus.
+//
+
+#ifndef TwoWire_h
+#define TwoWire_h
+
+#include <inttypes.h>
+
+#include "Print.h"
+
+#define BUFFER_LENGTH 32
+
+class TwoWire : public Print {
+public:
+    TwoWire();
+    void begin();
+    void setClock(uint32_t clock) { clockHz = clock; }
+    void beginTransmission(uint8_t address);
+    void beginTransmission(int address) { beginTransmission((uint8_t) address); }
+    uint8_t endTransmission(void) { return endTransmission(true); }
+    uint8_t endTransmission(uint8_t sendStop);
+    uint8_t requestFrom(uint8_t address, uint8_t quantity);
+    virtual size_t write(uint8_t);
+    virtual size_t write(const uint8_t *data, size_t quantity);
+    int available(void) { return 0; }
+    int read(void) { return -1; }
+    using Print::write;
+
+private:
+    uint8_t txAddress;
+    uint8_t txBuffer[BUFFER_LENGTH];
+    uint8_t txLength;
+    bool transmitting;
+    uint32_t clockHz;
+};
+
+extern TwoWire Wire;
+
+#endif
@@ -0,0 +1,11 @@
+//
+// Interrupt handlers on the host. The core calls the ones it emulates, see
+// avr/io.h, with interrupts off like the AVR does on entry.
+//
+
+#ifndef INTERRUPT_H
+#define INTERRUPT_H
+
+#define ISR(vector) extern "C" void vector(void)
+
+#endif
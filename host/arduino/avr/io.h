@@ -0,0 +1,86 @@
+//
+// I/O registers on the host. Two peripherals are emulated, the rest of the
+// ATmega328 registers are only used behind __AVR__:
+//
+// USART0 on pins 0 (RXD) and 1 (TXD): a frame written to UDR0 is shifted
+// out on TXD on the virtual clock while RXD is sampled in the middle of
+// every bit, and the RX complete interrupt runs when interrupts are
+// enabled.
+//
+// Timer1 in normal mode: TCNT1 counts on the virtual clock at the TCCR1B
+// prescaler, a match with OCR1A sets OCF1A in TIFR1 and runs the compare A
+// interrupt when OCIE1A is set in TIMSK1 and interrupts are enabled. An
+// idle sleep ends at the match. TCCR1A and the other compare and capture
+// units are not emulated.
+//
+
+#ifndef IO_H
+#define IO_H
+
+#include <stdint.h>
+
+#define _BV(bit) (1 << (bit))
+
+// UCSR0A
+#define RXC0 7
+#define TXC0 6
+#define UDRE0 5
+#define FE0 4
+#define U2X0 1
+// UCSR0B
+#define RXCIE0 7
+#define RXEN0 4
+#define TXEN0 3
+// UCSR0C, 8N1 is the only frame format
+#define UCSZ01 2
+#define UCSZ00 1
+// TCCR1B
+#define CS12 2
+#define CS11 1
+#define CS10 0
+// TIMSK1, TIFR1
+#define OCIE1A 1
+#define OCF1A 1
+
+#ifdef __cplusplus
+// Writing starts a frame, reading returns the last one received and
+// clears RXC0 and FE0 in UCSR0A
+class UsartDataRegister {
+public:
+    operator uint8_t() const;
+    UsartDataRegister &operator=(uint8_t value);
+};
+extern UsartDataRegister UDR0;
+
+// TCCR1B, TCNT1, OCR1A and TIFR1 move the emulated timer on access.
+// Writing 1 to a TIFR1 bit clears it, like on the AVR.
+class Timer1Register {
+public:
+    enum Name {
+        CONTROL_B,
+        COUNTER,
+        COMPARE_A,
+        FLAGS
+    };
+
+    explicit Timer1Register(Name name) : name(name) {}
+    operator uint16_t() const;
+    Timer1Register &operator=(uint16_t value);
+
+private:
+    const Name name;
+};
+extern Timer1Register TCCR1B;
+extern Timer1Register TCNT1;
+extern Timer1Register OCR1A;
+extern Timer1Register TIFR1;
+#endif
+
+extern volatile uint16_t UBRR0;
+extern volatile uint8_t UCSR0A;
+extern volatile uint8_t UCSR0B;
+extern volatile uint8_t UCSR0C;
+extern volatile uint8_t TCCR1A;
+extern volatile uint8_t TIMSK1;
+
+#endif
@@ -0,0 +1,18 @@
+//
+// Program memory is ordinary memory on the host.
+//
+
+#ifndef PGMSPACE_H
+#define PGMSPACE_H
+
+#include <stdint.h>
+#include <string.h>
+
+#define PROGMEM
+#define PSTR(s) (s)
+#define pgm_read_byte(addr) (*(const uint8_t *) (addr))
+#define pgm_read_word(addr) (*(const uint16_t *) (addr))
+#define strlen_P strlen
+#define memcpy_P memcpy
+
+#endif
@@ -0,0 +1,23 @@
+//
+// Sleep modes on the host. sleep_cpu() hands the virtual clock on to the
+// next interrupt the simulator knows of, or to an input change, whichever
+// comes first.
+//
+
+#ifndef SLEEP_H
+#define SLEEP_H
+
+#include <stdint.h>
+
+#define SLEEP_MODE_IDLE 0
+#define SLEEP_MODE_PWR_DOWN 2
+
+void set_sleep_mode(uint8_t mode);
+#define sleep_enable()
+#define sleep_disable()
+// Idle: the next Timer0 tick, i.e. the next whole millisecond, or the
+// Timer1 compare match, see avr/io.h. Power-down: the watchdog timeout, see
+// avr/wdt.h, or forever without one.
+void sleep_cpu(void);
+
+#endif
@@ -0,0 +1,111 @@
+//
+// The controller's hardware around the simulated Uno.
+//
+
+#include <Arduino.h>
+
+#include "CamperBoard.h"
+
+#define CONVERTER_MAX_VOLTS 25.0f
+
+
+namespace {
+
+    const char keyMap[] = {
+        '1', '2', '3',
+        '4', '5', '6',
+        '7', '8', '9',
+        '*', '0', '#'
+    };
+    const uint8_t rowPins[] = {7, 8, 9, 10};
+    const uint8_t colPins[] = {11, 12, 13};
+
+    // The search takes the 0 branch first from the low bit up, these come
+    // out in this order
+    const uint8_t sensorSerials[] = {0x80, 0x40, 0xC0, 0x20};
+    const float sensorTemperatures[] = {21.5f, 4.0f, 12.0f, 15.0f};
+
+    uint16_t converterReading(float value) {
+        if (value <= 0)
+            return 0;
+        long reading = (long) (value / CONVERTER_MAX_VOLTS * 1024.0f);
+        return reading > 1023 ? 1023 : (uint16_t) reading;
+    }
+
+}
+
+
+namespace sim {
+
+    const uint8_t CamperBoard::doorSensorPins[3] = {5, 4, 3};
+
+    CamperBoard::CamperBoard()
+    : bus(oneWirePin),
+      sensors{Ds18b20(sensorSerials[0]), Ds18b20(sensorSerials[1]),
+              Ds18b20(sensorSerials[2]), Ds18b20(sensorSerials[3])},
+      display(lcdAddress, 16, 2),
+      matrix(keyMap, rowPins, sizeof(rowPins), colPins, sizeof(colPins)) {
+        for (uint8_t i = 0; i < temperatureSensorCount; i++) {
+            bus.add(&sensors[i]);
+            sensors[i].setTemperature(sensorTemperatures[i]);
+        }
+
+        for (uint8_t i = 0; i < 3; i++)
+            setDoorOpen(i, false);
+        setMenuButton(false);
+        setBattery1Voltage(12.6f);
+        setBattery2Voltage(12.4f);
+        setBattery2Current(0.0f);
+    }
+
+    void CamperBoard::setDoorOpen(uint8_t door, bool open) {
+        if (door < 3)
+            setInput(doorSensorPins[door], open ? HIGH : LOW);
+    }
+
+    void CamperBoard::setMenuButton(bool pressed) {
+        setInput(menuButtonPin, pressed ? HIGH : LOW);
+    }
+
+    void CamperBoard::setBattery1Voltage(float volts) {
+        setAnalog(battery1VoltagePin, converterReading(volts));
+    }
+
+    void CamperBoard::setBattery2Voltage(float volts) {
+        setAnalog(battery2VoltagePin, converterReading(volts));
+    }
+
+    void CamperBoard::setBattery2Current(float amps) {
+        // The current sensor sits behind the same converter as the voltmeters
+        setAnalog(battery2CurrentPin, converterReading(amps));
+    }
+
+    KeypadMatrix &CamperBoard::keypad() {
+        return matrix;
+    }
+
+    Hd44780 &CamperBoard::lcd() {
+        return display;
+    }
+
+    Ds18b20 &CamperBoard::temperatureSensor(uint8_t index) {
+        return sensors[index < temperatureSensorCount ? index : 0];
+    }
+
+    OneWireBus &CamperBoard::oneWire() {
+        return bus;
+    }
+
+    bool CamperBoard::armedLed() const {
+        return outputLevel(armedLedPin);
+    }
+
+    bool CamperBoard::alarmRelay() const {
+        return outputLevel(alarmRelayPin);
+    }
+
+    bool CamperBoard::secondBatteryRelay() const {
+        return outputLevel(secondBatteryRelayPin);
+    }
+
+}
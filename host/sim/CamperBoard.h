@@ -0,0 +1,62 @@
+//
+// The controller's hardware around the simulated Uno: door sensors, menu
+// button, keypad, LCD, DS18B20s and the battery voltage/current inputs.
+// Pin numbers mirror the definitions at the top of src/main.cpp.
+//
+
+#ifndef SIM_CAMPERBOARD_H
+#define SIM_CAMPERBOARD_H
+
+#include <stdint.h>
+
+#include "Hd44780.h"
+#include "KeypadMatrix.h"
+#include "OneWireBus.h"
+
+namespace sim {
+
+    class CamperBoard {
+    public:
+        static const uint8_t doorSensorPins[3];
+        static const uint8_t menuButtonPin = 6;
+        static const uint8_t armedLedPin = 2;
+        static const uint8_t alarmRelayPin = 1;
+        static const uint8_t secondBatteryRelayPin = 0;
+        static const uint8_t battery1VoltagePin = 14;   // A0
+        static const uint8_t battery2VoltagePin = 15;   // A1
+        static const uint8_t battery2CurrentPin = 16;   // A2
+        static const uint8_t oneWirePin = 17;           // A3
+        static const uint8_t lcdAddress = 0x27;
+        // Cabin, fridge, outside and battery bay, in bus search order
+        static const uint8_t temperatureSensorCount = 4;
+
+        CamperBoard();
+
+        // Sensors and the button read HIGH when active
+        void setDoorOpen(uint8_t door, bool open);
+        void setMenuButton(bool pressed);
+
+        // 0-25 V divider in front of a 5 V ADC
+        void setBattery1Voltage(float volts);
+        void setBattery2Voltage(float volts);
+        void setBattery2Current(float amps);
+
+        KeypadMatrix &keypad();
+        Hd44780 &lcd();
+        Ds18b20 &temperatureSensor(uint8_t index = 0);
+        OneWireBus &oneWire();
+
+        bool armedLed() const;
+        bool alarmRelay() const;
+        bool secondBatteryRelay() const;
+
+    private:
+        OneWireBus bus;
+        Ds18b20 sensors[temperatureSensorCount];
+        Hd44780 display;
+        KeypadMatrix matrix;
+    };
+
+}
+
+#endif
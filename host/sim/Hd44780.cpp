@@ -0,0 +1,169 @@
+//
+// HD44780 over PCF8574 model for host builds.
+//
+
+#include <string.h>
+
+#include "Hd44780.h"
+
+#define EXPANDER_RS 0x01
+#define EXPANDER_EN 0x04
+#define EXPANDER_BACKLIGHT 0x08
+
+// Second display line starts at DDRAM address 0x40
+#define LINE_LENGTH 0x28
+#define LINE_2 0x40
+
+
+namespace sim {
+
+    Hd44780::Hd44780(uint8_t address, uint8_t cols, uint8_t rows)
+    : cols(cols), rows(rows), address(0), fourBitMode(false), highNibble(true),
+      pending(0), cgramAccess(false), increment(true), display(false), expander(0xFF),
+      changes(0), bytes(0), transfers(0), dataWrites(0), commandWrites(0) {
+        memset(ddram, ' ', sizeof(ddram));
+        attachI2c(address, this);
+    }
+
+    void Hd44780::receive(const uint8_t *data, size_t length) {
+        transfers++;
+        bytes += length;
+        for (size_t i = 0; i < length; i++) {
+            // The display latches the data lines on the falling edge of E
+            if ((expander & EXPANDER_EN) && !(data[i] & EXPANDER_EN))
+                strobe(expander);
+            if ((expander ^ data[i]) & EXPANDER_BACKLIGHT)
+                changes++;
+            expander = data[i];
+        }
+    }
+
+    void Hd44780::strobe(uint8_t value) {
+        uint8_t nibble = value & 0xF0;
+        bool data = value & EXPANDER_RS;
+
+        if (!fourBitMode) {
+            // 8 bit interface, the low data lines are not wired
+            execute(data, nibble);
+            return;
+        }
+
+        if (highNibble) {
+            pending = nibble;
+            highNibble = false;
+        } else {
+            highNibble = true;
+            execute(data, pending | (nibble >> 4));
+        }
+    }
+
+    void Hd44780::execute(bool data, uint8_t value) {
+        if (!data) {
+            commandWrites++;
+            instruction(value);
+            return;
+        }
+
+        dataWrites++;
+        if (cgramAccess)
+            return;
+        if (ddram[address] != value)
+            changes++;
+        ddram[address] = value;
+        advanceAddress();
+    }
+
+    void Hd44780::instruction(uint8_t value) {
+        if (value & 0x80) {
+            address = value & 0x7F;
+            cgramAccess = false;
+        } else if (value & 0x40) {
+            cgramAccess = true;
+        } else if (value & 0x20) {
+            fourBitMode = !(value & 0x10);
+            highNibble = true;
+        } else if (value & 0x10) {
+            // Cursor or display shift, only cursor moves are modelled
+            if (!(value & 0x08)) {
+                bool right = value & 0x04;
+                bool saved = increment;
+                increment = right;
+                advanceAddress();
+                increment = saved;
+            }
+        } else if (value & 0x08) {
+            if (display != (bool) (value & 0x04))
+                changes++;
+            display = value & 0x04;
+        } else if (value & 0x04) {
+            increment = value & 0x02;
+        } else if (value & 0x02) {
+            address = 0;
+        } else if (value & 0x01) {
+            memset(ddram, ' ', sizeof(ddram));
+            address = 0;
+            increment = true;
+            changes++;
+        }
+    }
+
+    void Hd44780::advanceAddress() {
+        uint8_t line = address & LINE_2;
+        uint8_t offset = address & ~LINE_2;
+
+        if (increment)
+            offset = offset + 1 >= LINE_LENGTH ? 0 : offset + 1;
+        else
+            offset = offset == 0 ? LINE_LENGTH - 1 : offset - 1;
+
+        // Wrapping past the end of a line continues on the other one
+        if (increment && offset == 0)
+            line ^= LINE_2;
+        if (!increment && offset == LINE_LENGTH - 1)
+            line ^= LINE_2;
+        address = line | offset;
+    }
+
+    std::string Hd44780::line(uint8_t row) const {
+        if (row >= rows)
+            return std::string();
+        const uint8_t *start = ddram + (row ? LINE_2 : 0);
+        return std::string((const char *) start, cols);
+    }
+
+    bool Hd44780::backlight() const {
+        return expander & EXPANDER_BACKLIGHT;
+    }
+
+    bool Hd44780::displayOn() const {
+        return display;
+    }
+
+    unsigned long Hd44780::revision() const {
+        return changes;
+    }
+
+    unsigned long Hd44780::i2cBytes() const {
+        return bytes;
+    }
+
+    unsigned long Hd44780::transactions() const {
+        return transfers;
+    }
+
+    unsigned long Hd44780::characters() const {
+        return dataWrites;
+    }
+
+    unsigned long Hd44780::instructions() const {
+        return commandWrites;
+    }
+
+    void Hd44780::resetCounters() {
+        bytes = 0;
+        transfers = 0;
+        dataWrites = 0;
+        commandWrites = 0;
+    }
+
+}
@@ -0,0 +1,65 @@
+//
+// HD44780 character display behind a PCF8574 I2C expander, wired the way
+// LiquidCrystal_I2C expects (RS P0, RW P1, E P2, backlight P3, data P4-P7).
+// Decodes the enable strobes into instructions and keeps the DDRAM, so the
+// simulator can read back what the controller put on the screen.
+//
+
+#ifndef SIM_HD44780_H
+#define SIM_HD44780_H
+
+#include <stdint.h>
+#include <string>
+
+#include "SimCore.h"
+
+namespace sim {
+
+    class Hd44780 : public I2cDevice {
+    public:
+        Hd44780(uint8_t address, uint8_t cols, uint8_t rows);
+
+        virtual void receive(const uint8_t *data, size_t length);
+
+        std::string line(uint8_t row) const;
+        bool backlight() const;
+        bool displayOn() const;
+
+        // Changes whenever the visible content or the backlight changes
+        unsigned long revision() const;
+
+        // Traffic since power-on or resetCounters()
+        unsigned long i2cBytes() const;
+        unsigned long transactions() const;
+        unsigned long characters() const;
+        unsigned long instructions() const;
+        void resetCounters();
+
+    private:
+        uint8_t cols;
+        uint8_t rows;
+        uint8_t ddram[128];
+        uint8_t address;
+        bool fourBitMode;
+        bool highNibble;
+        uint8_t pending;
+        bool cgramAccess;
+        bool increment;
+        bool display;
+        uint8_t expander;
+        unsigned long changes;
+
+        unsigned long bytes;
+        unsigned long transfers;
+        unsigned long dataWrites;
+        unsigned long commandWrites;
+
+        void strobe(uint8_t value);
+        void execute(bool data, uint8_t value);
+        void instruction(uint8_t value);
+        void advanceAddress();
+    };
+
+}
+
+#endif
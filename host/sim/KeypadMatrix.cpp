@@ -0,0 +1,64 @@
+//
+// Key matrix model for host builds.
+//
+
+#include <string.h>
+
+#include "KeypadMatrix.h"
+
+
+namespace sim {
+
+    KeypadMatrix::KeypadMatrix(const char *keys, const uint8_t *rowPins, uint8_t rows,
+                               const uint8_t *colPins, uint8_t cols)
+    : keys(keys), rows(rows < maxRows ? rows : maxRows), cols(cols < maxCols ? cols : maxCols) {
+        memcpy(this->rowPins, rowPins, this->rows);
+        memcpy(this->colPins, colPins, this->cols);
+        releaseAll();
+        for (uint8_t r = 0; r < this->rows; r++)
+            attach(this->rowPins[r], this);
+    }
+
+    bool KeypadMatrix::find(char key, uint8_t &row, uint8_t &col) const {
+        for (row = 0; row < rows; row++) {
+            for (col = 0; col < cols; col++) {
+                if (keys[row * cols + col] == key)
+                    return true;
+            }
+        }
+        return false;
+    }
+
+    bool KeypadMatrix::press(char key) {
+        uint8_t row, col;
+        if (!find(key, row, col))
+            return false;
+        pressed[row][col] = true;
+        return true;
+    }
+
+    bool KeypadMatrix::release(char key) {
+        uint8_t row, col;
+        if (!find(key, row, col))
+            return false;
+        pressed[row][col] = false;
+        return true;
+    }
+
+    void KeypadMatrix::releaseAll() {
+        memset(pressed, 0, sizeof(pressed));
+    }
+
+    int KeypadMatrix::pinLevel(uint8_t pin) {
+        for (uint8_t r = 0; r < rows; r++) {
+            if (rowPins[r] != pin)
+                continue;
+            for (uint8_t c = 0; c < cols; c++) {
+                if (pressed[r][c] && isOutput(colPins[c]) && !outputLevel(colPins[c]))
+                    return 0;
+            }
+        }
+        return -1;
+    }
+
+}
@@ -0,0 +1,44 @@
+//
+// Key matrix model for host builds. A pressed key connects its row and
+// column, so a row pin reads low while the column it shares with a pressed
+// key is driven low.
+//
+
+#ifndef SIM_KEYPADMATRIX_H
+#define SIM_KEYPADMATRIX_H
+
+#include <stdint.h>
+
+#include "SimCore.h"
+
+namespace sim {
+
+    class KeypadMatrix : public PinDevice {
+    public:
+        static const uint8_t maxRows = 8;
+        static const uint8_t maxCols = 8;
+
+        KeypadMatrix(const char *keys, const uint8_t *rowPins, uint8_t rows,
+                     const uint8_t *colPins, uint8_t cols);
+
+        // Returns false for characters that are not on the keypad
+        bool press(char key);
+        bool release(char key);
+        void releaseAll();
+
+        virtual int pinLevel(uint8_t pin);
+
+    private:
+        const char *keys;
+        uint8_t rowPins[maxRows];
+        uint8_t colPins[maxCols];
+        uint8_t rows;
+        uint8_t cols;
+        bool pressed[maxRows][maxCols];
+
+        bool find(char key, uint8_t &row, uint8_t &col) const;
+    };
+
+}
+
+#endif
@@ -0,0 +1,476 @@
+//
+// 1-Wire bus model for host builds.
+//
+
+#include <math.h>
+#include <string.h>
+
+#include "OneWireBus.h"
+
+// Slot timing as seen by the slaves, in microseconds
+#define RESET_LOW_MIN 480
+#define PRESENCE_DELAY 15
+#define PRESENCE_LENGTH 120
+#define WRITE_ONE_MAX 15
+#define READ_ZERO_HOLD 30
+#define RESET_RECOVERY 480
+#define SLOT_MAX 120
+
+#define FAMILY_DS18S20 0x10
+#define FAMILY_DS18B20 0x28
+
+// Function commands handled by the DS18B20 model
+#define CMD_SEARCH_ROM 0xF0
+#define CMD_READ_ROM 0x33
+#define CMD_MATCH_ROM 0x55
+#define CMD_SKIP_ROM 0xCC
+#define CMD_ALARM_SEARCH 0xEC
+#define CMD_CONVERT_T 0x44
+#define CMD_WRITE_SCRATCHPAD 0x4E
+#define CMD_READ_SCRATCHPAD 0xBE
+#define CMD_COPY_SCRATCHPAD 0x48
+#define CMD_RECALL_EEPROM 0xB8
+#define CMD_READ_POWER_SUPPLY 0xB4
+
+#define TH_REGISTER 2
+#define TL_REGISTER 3
+#define CONFIG_REGISTER 4
+#define COUNT_REMAIN_REGISTER 6
+#define COUNT_PER_C_REGISTER 7
+#define CRC_REGISTER 8
+
+
+namespace sim {
+
+    uint8_t crc8(const uint8_t *data, uint8_t length) {
+        /* Dallas/Maxim CRC, x^8 + x^5 + x^4 + 1 */
+        uint8_t crc = 0;
+        while (length--) {
+            uint8_t in = *data++;
+            for (uint8_t i = 0; i < 8; i++) {
+                uint8_t mix = (crc ^ in) & 0x01;
+                crc >>= 1;
+                if (mix)
+                    crc ^= 0x8C;
+                in >>= 1;
+            }
+        }
+        return crc;
+    }
+
+
+    Ds18b20::Ds18b20(uint8_t serial, bool parasite)
+    : Ds18b20(FAMILY_DS18B20, serial, parasite) {
+    }
+
+    Ds18b20::Ds18b20(uint8_t family, uint8_t serial, bool parasite)
+    : parasite(parasite), temperature(85.0f), phase(INACTIVE), command(0), shift(0),
+      bitCount(0), searchStep(0), romMatches(false), txData(NULL), txLength(0),
+      rxLength(0), converting(false), starved(false), alarmFlag(false), countRemain(0),
+      conversionDone(0), starvedCount(0) {
+        rom[0] = family;
+        rom[1] = serial;
+        for (uint8_t i = 2; i < 7; i++)
+            rom[i] = 0;
+        rom[7] = crc8(rom, 7);
+
+        // Factory EEPROM: no alarms, 12 bit resolution
+        eeprom[0] = 0x4B;
+        eeprom[1] = 0x46;
+        eeprom[2] = ds18s20() ? 0xFF : 0x7F;
+        powerOn();
+    }
+
+    Ds18s20::Ds18s20(uint8_t serial, bool parasite)
+    : Ds18b20(FAMILY_DS18S20, serial, parasite) {
+    }
+
+    void Ds18b20::setTemperature(float celsius) {
+        temperature = celsius;
+    }
+
+    float Ds18b20::getTemperature() const {
+        return temperature;
+    }
+
+    const uint8_t *Ds18b20::address() const {
+        return rom;
+    }
+
+    unsigned long Ds18b20::starvedConversions() const {
+        return starvedCount;
+    }
+
+    void Ds18b20::powerLoss() {
+        powerOn();
+    }
+
+    void Ds18b20::powerOn() {
+        /* Power-on register contents: 85 C, the rest from the EEPROM */
+        if (ds18s20()) {
+            scratchpad[0] = 0xAA;
+            scratchpad[1] = 0x00;
+        } else {
+            scratchpad[0] = 0x50;
+            scratchpad[1] = 0x05;
+        }
+        scratchpad[TH_REGISTER] = eeprom[0];
+        scratchpad[TL_REGISTER] = eeprom[1];
+        scratchpad[CONFIG_REGISTER] = eeprom[2];
+        scratchpad[5] = 0xFF;
+        scratchpad[COUNT_REMAIN_REGISTER] = 0x0C;
+        scratchpad[COUNT_PER_C_REGISTER] = 0x10;
+        updateScratchpad();
+        phase = INACTIVE;
+        converting = false;
+        alarmFlag = false;
+    }
+
+    bool Ds18b20::ds18s20() const {
+        return rom[0] == FAMILY_DS18S20;
+    }
+
+    uint8_t Ds18b20::resolution() const {
+        if (ds18s20())
+            return 9;
+        return 9 + ((scratchpad[CONFIG_REGISTER] >> 5) & 0x03);
+    }
+
+    uint64_t Ds18b20::conversionTime() const {
+        return ds18s20() ? 750000 : 93750UL << (resolution() - 9);
+    }
+
+    void Ds18b20::startConversion(uint64_t now) {
+        /* The reading is taken now and shows up in the scratchpad when the
+           conversion time is over */
+        int16_t raw;
+        if (ds18s20()) {
+            // Half degrees, COUNT_REMAIN adds the rest in 1/16 C steps:
+            // T = (raw >> 1) - 0.25 + (16 - COUNT_REMAIN) / 16
+            raw = (int16_t) lroundf(temperature * 2.0f);
+            long sixteenths = lroundf((temperature - (raw >> 1) + 0.25f) * 16.0f);
+            countRemain = (uint8_t) (sixteenths < 0 ? 16 : sixteenths > 16 ? 0 : 16 - sixteenths);
+        } else {
+            raw = (int16_t) lroundf(temperature * 16.0f);
+            raw &= (int16_t) (0xFFFF << (12 - resolution()));
+        }
+        conversionResult[0] = (uint8_t) raw;
+        conversionResult[1] = (uint8_t) (raw >> 8);
+        converting = true;
+        starved = false;
+        conversionDone = now + conversionTime();
+    }
+
+    void Ds18b20::finishConversion(uint64_t now) {
+        if (!converting || now < conversionDone)
+            return;
+        converting = false;
+        if (starved)
+            return;
+
+        scratchpad[0] = conversionResult[0];
+        scratchpad[1] = conversionResult[1];
+        if (ds18s20())
+            scratchpad[COUNT_REMAIN_REGISTER] = countRemain;
+        updateScratchpad();
+
+        // The alarm flag compares the whole degrees with TH and TL after
+        // every conversion
+        int16_t raw = (int16_t) (scratchpad[1] << 8 | scratchpad[0]);
+        int8_t degrees = (int8_t) (ds18s20() ? raw >> 1 : raw >> 4);
+        alarmFlag = degrees >= (int8_t) scratchpad[TH_REGISTER] || degrees <= (int8_t) scratchpad[TL_REGISTER];
+    }
+
+    void Ds18b20::updateScratchpad() {
+        scratchpad[CRC_REGISTER] = crc8(scratchpad, CRC_REGISTER);
+    }
+
+    bool Ds18b20::romBit(uint8_t index) const {
+        return (rom[index >> 3] >> (index & 7)) & 0x01;
+    }
+
+    void Ds18b20::reset(uint64_t now) {
+        finishConversion(now);
+        phase = ROM_COMMAND;
+        shift = 0;
+        bitCount = 0;
+    }
+
+    void Ds18b20::startSending(const uint8_t *data, uint8_t length) {
+        txData = data;
+        txLength = length;
+        bitCount = 0;
+        phase = SEND;
+    }
+
+    void Ds18b20::romCommand(uint8_t value) {
+        bitCount = 0;
+        switch (value) {
+            case CMD_SEARCH_ROM:
+                phase = SEARCH;
+                searchStep = 0;
+                break;
+            case CMD_ALARM_SEARCH:
+                phase = alarmFlag ? SEARCH : INACTIVE;
+                searchStep = 0;
+                break;
+            case CMD_READ_ROM:
+                startSending(rom, sizeof(rom));
+                break;
+            case CMD_MATCH_ROM:
+                phase = MATCH_ROM;
+                romMatches = true;
+                break;
+            case CMD_SKIP_ROM:
+                phase = FUNCTION_COMMAND;
+                break;
+            default:
+                phase = INACTIVE;
+                break;
+        }
+    }
+
+    void Ds18b20::functionCommand(uint8_t value, uint64_t now) {
+        command = value;
+        bitCount = 0;
+        switch (value) {
+            case CMD_CONVERT_T:
+                startConversion(now);
+                phase = CONVERTING;
+                break;
+            case CMD_READ_SCRATCHPAD:
+                startSending(scratchpad, sizeof(scratchpad));
+                break;
+            case CMD_WRITE_SCRATCHPAD:
+                rxLength = 0;
+                shift = 0;
+                phase = RECEIVE;
+                break;
+            case CMD_COPY_SCRATCHPAD:
+                memcpy(eeprom, scratchpad + TH_REGISTER, sizeof(eeprom));
+                phase = READY;
+                break;
+            case CMD_RECALL_EEPROM:
+                memcpy(scratchpad + TH_REGISTER, eeprom, sizeof(eeprom));
+                updateScratchpad();
+                phase = READY;
+                break;
+            case CMD_READ_POWER_SUPPLY:
+                phase = READY;
+                break;
+            default:
+                phase = INACTIVE;
+                break;
+        }
+    }
+
+    int Ds18b20::transmitBit(uint64_t now) {
+        finishConversion(now);
+        switch (phase) {
+            case SEARCH:
+                // Address bit, its complement, then the master's choice
+                if (searchStep == 0)
+                    return romBit(bitCount);
+                if (searchStep == 1)
+                    return !romBit(bitCount);
+                return -1;
+
+            case SEND:
+                if (bitCount >= txLength * 8)
+                    return 1;
+                return (txData[bitCount >> 3] >> (bitCount & 7)) & 0x01;
+
+            case CONVERTING:
+                // Parasite powered parts can't pull the bus low meanwhile
+                return parasite || !converting;
+
+            case READY:
+                // Externally powered parts answer 1 to the power supply read
+                return command == CMD_READ_POWER_SUPPLY ? !parasite : 1;
+
+            case ROM_COMMAND:
+            case MATCH_ROM:
+            case FUNCTION_COMMAND:
+            case RECEIVE:
+                return -1;
+
+            default:
+                return 1;
+        }
+    }
+
+    void Ds18b20::receiveBit(bool bit, uint64_t now) {
+        finishConversion(now);
+        switch (phase) {
+            case SEARCH:
+                if (searchStep < 2) {
+                    searchStep++;
+                    return;
+                }
+                searchStep = 0;
+                if (bit != romBit(bitCount)) {
+                    phase = INACTIVE;
+                    return;
+                }
+                if (++bitCount == 64) {
+                    bitCount = 0;
+                    phase = FUNCTION_COMMAND;
+                }
+                return;
+
+            case SEND:
+                bitCount++;
+                return;
+
+            case MATCH_ROM:
+                if (bit != romBit(bitCount))
+                    romMatches = false;
+                if (++bitCount == 64) {
+                    bitCount = 0;
+                    shift = 0;
+                    phase = romMatches ? FUNCTION_COMMAND : INACTIVE;
+                }
+                return;
+
+            case ROM_COMMAND:
+            case FUNCTION_COMMAND:
+            case RECEIVE:
+                break;
+
+            default:
+                return;
+        }
+
+        shift = (shift >> 1) | (bit ? 0x80 : 0);
+        if (++bitCount < 8)
+            return;
+
+        uint8_t value = shift;
+        shift = 0;
+        bitCount = 0;
+        if (phase == ROM_COMMAND) {
+            romCommand(value);
+        } else if (phase == FUNCTION_COMMAND) {
+            functionCommand(value, now);
+        } else {
+            // TH, TL and, except on the DS18S20, the configuration
+            rxBuffer[rxLength++] = value;
+            if (rxLength == (ds18s20() ? 2 : sizeof(rxBuffer))) {
+                scratchpad[TH_REGISTER] = rxBuffer[0];
+                scratchpad[TL_REGISTER] = rxBuffer[1];
+                if (!ds18s20())
+                    scratchpad[CONFIG_REGISTER] = (rxBuffer[2] & 0x60) | 0x1F;
+                updateScratchpad();
+                phase = READY;
+            }
+        }
+    }
+
+    void Ds18b20::powerChanged(bool strong, uint64_t now) {
+        finishConversion(now);
+        if (parasite && converting && !starved && !strong) {
+            starved = true;
+            starvedCount++;
+        }
+    }
+
+
+    OneWireBus::OneWireBus(uint8_t pin)
+    : masterLow(false), masterHigh(false), fallTime(0), presenceStart(0), holdLowUntil(0),
+      resetCount(0), slotCount(0), busTime(0), eventStart(0), eventLimit(0) {
+        attach(pin, this);
+    }
+
+    void OneWireBus::add(OneWireDevice *device) {
+        devices.push_back(device);
+        listening.push_back(false);
+    }
+
+    void OneWireBus::pinChanged(uint8_t pin, bool output, bool level) {
+        (void) pin;
+        uint64_t t = now();
+
+        // Parasite powered devices only run from a strong pull-up
+        bool high = output && level;
+        if (high != masterHigh) {
+            masterHigh = high;
+            for (size_t i = 0; i < devices.size(); i++)
+                devices[i]->powerChanged(high, t);
+        }
+
+        bool low = output && !level;
+        if (low == masterLow)
+            return;
+        masterLow = low;
+
+        if (low) {
+            endEvent(t);
+            fallTime = t;
+            holdLowUntil = 0;
+            for (size_t i = 0; i < devices.size(); i++) {
+                int bit = devices[i]->transmitBit(t);
+                listening[i] = bit < 0;
+                if (bit == 0)
+                    holdLowUntil = t + READ_ZERO_HOLD;
+            }
+            return;
+        }
+
+        uint64_t width = t - fallTime;
+        eventStart = fallTime;
+        if (width >= RESET_LOW_MIN) {
+            resetCount++;
+            eventLimit = width + RESET_RECOVERY;
+            presenceStart = devices.empty() ? 0 : t + PRESENCE_DELAY;
+            for (size_t i = 0; i < devices.size(); i++)
+                devices[i]->reset(t);
+            return;
+        }
+
+        slotCount++;
+        eventLimit = SLOT_MAX;
+        for (size_t i = 0; i < devices.size(); i++) {
+            // A read slot looks like a 1 to every device that is listening
+            devices[i]->receiveBit(listening[i] ? width < WRITE_ONE_MAX : false, t);
+        }
+    }
+
+    void OneWireBus::endEvent(uint64_t t) {
+        if (eventLimit == 0)
+            return;
+        uint64_t length = t - eventStart;
+        busTime += length < eventLimit ? length : eventLimit;
+        eventLimit = 0;
+    }
+
+    int OneWireBus::pinLevel(uint8_t pin) {
+        (void) pin;
+        uint64_t t = now();
+        if (presenceStart && t >= presenceStart && t < presenceStart + PRESENCE_LENGTH)
+            return 0;
+        if (t < holdLowUntil)
+            return 0;
+        // Everything released, the 4.7k resistor pulls the line up
+        return 1;
+    }
+
+    unsigned long OneWireBus::resets() const {
+        return resetCount;
+    }
+
+    unsigned long OneWireBus::slots() const {
+        return slotCount;
+    }
+
+    uint64_t OneWireBus::busMicros() const {
+        uint64_t t = now();
+        uint64_t pending = 0;
+        if (eventLimit) {
+            pending = t - eventStart;
+            if (pending > eventLimit)
+                pending = eventLimit;
+        }
+        return busTime + pending;
+    }
+
+}
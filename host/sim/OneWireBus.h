@@ -0,0 +1,161 @@
+//
+// 1-Wire bus model for host builds. Decodes the master's reset pulses and
+// time slots from pin changes on the virtual clock and lets the attached
+// DS18B20/DS18S20 models answer the way the real sensors do, including
+// presence pulses, ROM and alarm search, the conversion busy signal and
+// parasite power. Counts resets, slots and the time the bus was busy, so
+// protocol code can be measured.
+//
+
+#ifndef SIM_ONEWIREBUS_H
+#define SIM_ONEWIREBUS_H
+
+#include <stdint.h>
+#include <vector>
+
+#include "SimCore.h"
+
+namespace sim {
+
+    class OneWireDevice {
+    public:
+        virtual ~OneWireDevice() {}
+
+        virtual void reset(uint64_t now) = 0;
+
+        // Start of a time slot: the bit the device sends, or -1 if it listens
+        virtual int transmitBit(uint64_t now) = 0;
+
+        // End of a time slot the device listened to
+        virtual void receiveBit(bool bit, uint64_t now) = 0;
+
+        // The master started or stopped driving the bus high, the strong
+        // pull-up parasite powered devices convert on
+        virtual void powerChanged(bool strong, uint64_t now) { (void) strong; (void) now; }
+    };
+
+
+    class Ds18b20 : public OneWireDevice {
+    public:
+        explicit Ds18b20(uint8_t serial, bool parasite = false);
+
+        // Takes effect with the next conversion, like a real sensor
+        void setTemperature(float celsius);
+        float getTemperature() const;
+        const uint8_t *address() const;
+
+        // A parasite powered conversion that lost the strong pull-up before
+        // it was done leaves the old reading in the scratchpad
+        unsigned long starvedConversions() const;
+
+        // Brown-out: back to the power-on registers, 85 C and TH, TL and the
+        // configuration from the EEPROM, which Copy Scratchpad writes
+        void powerLoss();
+
+        virtual void reset(uint64_t now);
+        virtual int transmitBit(uint64_t now);
+        virtual void receiveBit(bool bit, uint64_t now);
+        virtual void powerChanged(bool strong, uint64_t now);
+
+    protected:
+        Ds18b20(uint8_t family, uint8_t serial, bool parasite);
+
+    private:
+        enum Phase {
+            INACTIVE,
+            ROM_COMMAND,
+            SEARCH,
+            MATCH_ROM,
+            FUNCTION_COMMAND,
+            SEND,
+            RECEIVE,
+            CONVERTING,
+            READY
+        };
+
+        uint8_t rom[8];
+        uint8_t scratchpad[9];
+        uint8_t eeprom[3];
+        bool parasite;
+        float temperature;
+
+        Phase phase;
+        uint8_t command;
+        uint8_t shift;
+        uint8_t bitCount;
+        uint8_t searchStep;
+        bool romMatches;
+        const uint8_t *txData;
+        uint8_t txLength;
+        uint8_t rxBuffer[3];
+        uint8_t rxLength;
+        bool converting;
+        bool starved;
+        bool alarmFlag;
+        uint8_t conversionResult[2];
+        uint8_t countRemain;
+        uint64_t conversionDone;
+        unsigned long starvedCount;
+
+        bool ds18s20() const;
+        uint8_t resolution() const;
+        uint64_t conversionTime() const;
+        void powerOn();
+        void startConversion(uint64_t now);
+        void finishConversion(uint64_t now);
+        void updateScratchpad();
+        void romCommand(uint8_t value);
+        void functionCommand(uint8_t value, uint64_t now);
+        void startSending(const uint8_t *data, uint8_t length);
+        bool romBit(uint8_t index) const;
+    };
+
+
+    // 9 bit DS18S20 (and DS1820): 0.5 C register plus COUNT_REMAIN for the
+    // extended reading, always 750 ms per conversion, no configuration byte
+    class Ds18s20 : public Ds18b20 {
+    public:
+        explicit Ds18s20(uint8_t serial, bool parasite = false);
+    };
+
+
+    class OneWireBus : public PinDevice {
+    public:
+        explicit OneWireBus(uint8_t pin);
+
+        void add(OneWireDevice *device);
+
+        virtual void pinChanged(uint8_t pin, bool output, bool level);
+        virtual int pinLevel(uint8_t pin);
+
+        unsigned long resets() const;
+        unsigned long slots() const;
+        // Microseconds the bus was busy: every reset and slot from its
+        // falling edge to the next one, at most the longest reset (low
+        // time + 480 us) or slot (120 us) the specification allows, so
+        // the gaps between transactions don't count
+        uint64_t busMicros() const;
+
+    private:
+        std::vector<OneWireDevice *> devices;
+        std::vector<bool> listening;
+        bool masterLow;
+        bool masterHigh;
+        uint64_t fallTime;
+        uint64_t presenceStart;
+        uint64_t holdLowUntil;
+        unsigned long resetCount;
+        unsigned long slotCount;
+        uint64_t busTime;
+        uint64_t eventStart;
+        uint64_t eventLimit;
+
+        void endEvent(uint64_t t);
+    };
+
+
+    uint8_t crc8(const uint8_t *data, uint8_t length);
+
+}
+
+#endif
@@ -0,0 +1,254 @@
+//
+// Scripted input for the simulator.
+//
+
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <fstream>
+#include <sstream>
+
+#include "Scenario.h"
+
+#define KEY_TAP_US 100000
+#define KEY_SPACING_US 250000
+#define CLICK_US 100000
+#define DEFAULT_TAIL_US 1000000
+
+
+namespace sim {
+
+    bool parseTime(const std::string &text, uint64_t &us) {
+        char *unit;
+        double value = strtod(text.c_str(), &unit);
+        if (unit == text.c_str() || value < 0)
+            return false;
+
+        std::string suffix(unit);
+        double scale;
+        if (suffix.empty() || suffix == "ms")
+            scale = 1e3;
+        else if (suffix == "s")
+            scale = 1e6;
+        else if (suffix == "m")
+            scale = 60e6;
+        else if (suffix == "h")
+            scale = 3600e6;
+        else
+            return false;
+
+        us = (uint64_t) (value * scale + 0.5);
+        return true;
+    }
+
+
+    Scenario::Scenario()
+    : end(0), endGiven(false) {
+    }
+
+    bool Scenario::load(const char *path, std::string &error) {
+        std::ifstream file(path);
+        if (!file) {
+            error = std::string("cannot open ") + path;
+            return false;
+        }
+        std::stringstream text;
+        text << file.rdbuf();
+        return parse(text.str(), error);
+    }
+
+    bool Scenario::parse(const std::string &text, std::string &error) {
+        std::istringstream lines(text);
+        std::string line;
+        unsigned number = 0;
+
+        while (std::getline(lines, line)) {
+            number++;
+            if (!parseLine(line, error)) {
+                char prefix[32];
+                snprintf(prefix, sizeof(prefix), "line %u: ", number);
+                error = prefix + error;
+                return false;
+            }
+        }
+
+        if (!endGiven)
+            end = (actions.empty() ? 0 : actions.rbegin()->first) + DEFAULT_TAIL_US;
+        return true;
+    }
+
+    Scenario::Action &Scenario::add(uint64_t time, Type type, int index, float value, char key) {
+        Action action;
+        action.type = type;
+        action.index = index;
+        action.value = value;
+        action.key = key;
+        return actions.insert(std::make_pair(time, action))->second;
+    }
+
+    bool Scenario::parseLine(const std::string &line, std::string &error) {
+        std::istringstream words(line);
+        std::string when, what;
+        if (!(words >> when) || when[0] == '#')
+            return true;
+
+        uint64_t time;
+        if (!parseTime(when, time)) {
+            error = "bad time '" + when + "'";
+            return false;
+        }
+        if (!(words >> what)) {
+            error = "missing action";
+            return false;
+        }
+
+        std::string arg;
+        words >> arg;
+
+        if (what == "end") {
+            end = time;
+            endGiven = true;
+        } else if (what == "door") {
+            std::string state;
+            words >> state;
+            int door = atoi(arg.c_str());
+            if (door < 1 || door > 3 || (state != "open" && state != "closed")) {
+                error = "expected: door <1-3> open|closed";
+                return false;
+            }
+            add(time, DOOR, door - 1, state == "open", 0);
+        } else if (what == "menu") {
+            if (arg == "press" || arg == "click")
+                add(time, MENU, 0, 1, 0);
+            if (arg == "release")
+                add(time, MENU, 0, 0, 0);
+            else if (arg == "click")
+                add(time + CLICK_US, MENU, 0, 0, 0);
+            else if (arg != "press") {
+                error = "expected: menu press|release|click";
+                return false;
+            }
+        } else if (what == "chatter") {
+            int door = 0;
+            if (arg == "door") {
+                std::string number;
+                words >> number;
+                door = atoi(number.c_str());
+            }
+            std::string period, duration;
+            uint64_t periodUs, durationUs;
+            words >> period >> duration;
+            if ((arg != "menu" && (door < 1 || door > 3)) ||
+                !parseTime(period, periodUs) || !parseTime(duration, durationUs) || periodUs == 0) {
+                error = "expected: chatter menu|door <n> <period> <duration>";
+                return false;
+            }
+            bool active = true;
+            for (uint64_t t = 0; t < durationUs; t += periodUs, active = !active) {
+                if (door)
+                    add(time + t, DOOR, door - 1, active, 0);
+                else
+                    add(time + t, MENU, 0, active, 0);
+            }
+            if (door)
+                add(time + durationUs, DOOR, door - 1, 0, 0);
+            else
+                add(time + durationUs, MENU, 0, 0, 0);
+        } else if (what == "key" || what == "press" || what == "release") {
+            if (arg.size() != 1) {
+                error = "expected a single key character";
+                return false;
+            }
+            if (what != "release")
+                add(time, KEY_DOWN, 0, 0, arg[0]);
+            if (what == "key")
+                add(time + KEY_TAP_US, KEY_UP, 0, 0, arg[0]);
+            else if (what == "release")
+                add(time, KEY_UP, 0, 0, arg[0]);
+        } else if (what == "keys") {
+            for (size_t i = 0; i < arg.size(); i++) {
+                add(time + i * KEY_SPACING_US, KEY_DOWN, 0, 0, arg[i]);
+                add(time + i * KEY_SPACING_US + KEY_TAP_US, KEY_UP, 0, 0, arg[i]);
+            }
+        } else if (what == "battery1" || what == "battery2" || what == "current2" || what == "temp") {
+            int sensor = 0;
+            if (what == "temp" && !arg.empty() && isalpha((unsigned char) arg[0])) {
+                static const char *const names[] = {"cabin", "fridge", "outside", "bay"};
+                for (sensor = 0; sensor < 4 && arg != names[sensor]; sensor++)
+                    ;
+                if (sensor == 4) {
+                    error = "expected: temp [cabin|fridge|outside|bay] <celsius>";
+                    return false;
+                }
+                words >> arg;
+            }
+            char *rest;
+            float value = strtof(arg.c_str(), &rest);
+            if (arg.empty() || *rest) {
+                error = "expected a number after " + what;
+                return false;
+            }
+            Type type = what == "battery1" ? BATTERY_1 :
+                        what == "battery2" ? BATTERY_2 :
+                        what == "current2" ? CURRENT_2 : TEMPERATURE;
+            add(time, type, sensor, value, 0);
+        } else if (what == "mark") {
+            std::string rest;
+            std::getline(words, rest);
+            add(time, MARK, 0, 0, 0).text = arg + rest;
+        } else {
+            error = "unknown action '" + what + "'";
+            return false;
+        }
+        return true;
+    }
+
+    void Scenario::apply(uint64_t now, CamperBoard &board, std::string &marks) {
+        while (!actions.empty() && actions.begin()->first <= now) {
+            const Action &action = actions.begin()->second;
+            switch (action.type) {
+                case DOOR:
+                    board.setDoorOpen(action.index, action.value != 0);
+                    break;
+                case MENU:
+                    board.setMenuButton(action.value != 0);
+                    break;
+                case KEY_DOWN:
+                    board.keypad().press(action.key);
+                    break;
+                case KEY_UP:
+                    board.keypad().release(action.key);
+                    break;
+                case BATTERY_1:
+                    board.setBattery1Voltage(action.value);
+                    break;
+                case BATTERY_2:
+                    board.setBattery2Voltage(action.value);
+                    break;
+                case CURRENT_2:
+                    board.setBattery2Current(action.value);
+                    break;
+                case TEMPERATURE:
+                    board.temperatureSensor(action.index).setTemperature(action.value);
+                    break;
+                case MARK:
+                    marks += marks.empty() ? action.text : "; " + action.text;
+                    break;
+            }
+            actions.erase(actions.begin());
+        }
+    }
+
+    uint64_t Scenario::endTime() const {
+        return end;
+    }
+
+    uint64_t Scenario::nextTime() const {
+        return actions.empty() ? end : actions.begin()->first;
+    }
+
+    bool Scenario::finished() const {
+        return actions.empty();
+    }
+
+}
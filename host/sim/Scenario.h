@@ -0,0 +1,83 @@
+//
+// Scripted input for the simulator. A scenario is a text file with one
+// timed action per line:
+//
+//   # arm, open the front door and type the PIN
+//   0         battery1 12.6
+//   1s        key #
+//   7s        door 1 open
+//   8s        keys 1234
+//   30s       end
+//
+// Times are absolute, in ms unless suffixed with ms, s, m or h. Actions:
+//   door <1-3> open|closed     menu press|release|click
+//   key <c>   (100 ms tap)     press <c> / release <c>
+//   keys <chars> (taps 250 ms apart)
+//   battery1|battery2 <volts>  current2 <amps>
+//   temp [cabin|fridge|outside|bay] <celsius>  (cabin if not given)
+//   chatter menu|door <n> <toggle period> <duration>  (line noise, ends idle)
+//   mark <text>                end
+//
+
+#ifndef SIM_SCENARIO_H
+#define SIM_SCENARIO_H
+
+#include <stdint.h>
+#include <map>
+#include <string>
+
+#include "CamperBoard.h"
+
+namespace sim {
+
+    class Scenario {
+    public:
+        Scenario();
+
+        // Returns false and fills error on the first bad line
+        bool load(const char *path, std::string &error);
+        bool parse(const std::string &text, std::string &error);
+
+        // Applies every action due at or before 'now', marks are returned
+        // so the caller can put them in the trace
+        void apply(uint64_t now, CamperBoard &board, std::string &marks);
+
+        uint64_t endTime() const;
+        uint64_t nextTime() const;
+        bool finished() const;
+
+    private:
+        enum Type {
+            DOOR,
+            MENU,
+            KEY_DOWN,
+            KEY_UP,
+            BATTERY_1,
+            BATTERY_2,
+            CURRENT_2,
+            TEMPERATURE,
+            MARK
+        };
+
+        struct Action {
+            Type type;
+            int index;
+            float value;
+            char key;
+            std::string text;
+        };
+
+        std::multimap<uint64_t, Action> actions;
+        uint64_t end;
+        bool endGiven;
+
+        bool parseLine(const std::string &line, std::string &error);
+        Action &add(uint64_t time, Type type, int index, float value, char key);
+    };
+
+    // "1.5s", "250ms", "2m", "1h" or plain milliseconds
+    bool parseTime(const std::string &text, uint64_t &us);
+
+}
+
+#endif
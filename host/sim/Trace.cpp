@@ -0,0 +1,67 @@
+//
+// Timestamped record of the controller's outputs.
+//
+
+#include <inttypes.h>
+
+#include "Trace.h"
+
+
+namespace sim {
+
+    Trace::Trace(FILE *out, CamperBoard &board)
+    : out(out), board(board), lcdRevision(0), backlight(-1), count(0) {
+        addObserver(this);
+    }
+
+    void Trace::write(const char *signal, const std::string &value) {
+        uint64_t ms = now() / 1000;
+        fprintf(out, "%7" PRIu64 ".%03u %-10s %s\n", ms / 1000, (unsigned) (ms % 1000), signal, value.c_str());
+        count++;
+    }
+
+    void Trace::outputChanged(uint8_t pin, bool level) {
+        const char *signal;
+        if (pin == CamperBoard::secondBatteryRelayPin)
+            signal = "charge";
+        else if (pin == CamperBoard::alarmRelayPin)
+            signal = "alarm";
+        else if (pin == CamperBoard::armedLedPin)
+            signal = "led";
+        else
+            return;
+        write(signal, level ? "1" : "0");
+    }
+
+    void Trace::sleeping() {
+        poll();
+    }
+
+    void Trace::poll() {
+        Hd44780 &lcd = board.lcd();
+        if (lcd.revision() == lcdRevision)
+            return;
+        lcdRevision = lcd.revision();
+
+        for (uint8_t row = 0; row < 2; row++) {
+            std::string text = lcd.line(row);
+            if (text != lcdLines[row]) {
+                lcdLines[row] = text;
+                write(row ? "lcd1" : "lcd0", "|" + text + "|");
+            }
+        }
+        if (backlight != lcd.backlight()) {
+            backlight = lcd.backlight();
+            write("backlight", backlight ? "1" : "0");
+        }
+    }
+
+    void Trace::mark(const std::string &text) {
+        write("mark", text);
+    }
+
+    unsigned long Trace::lines() const {
+        return count;
+    }
+
+}
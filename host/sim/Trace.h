@@ -0,0 +1,44 @@
+//
+// Timestamped record of what the controller does with its outputs: relay
+// and LED levels, LCD lines and the backlight. One line per change, in
+// virtual time, so two builds can be compared with diff.
+//
+
+#ifndef SIM_TRACE_H
+#define SIM_TRACE_H
+
+#include <stdio.h>
+#include <string>
+
+#include "CamperBoard.h"
+
+namespace sim {
+
+    class Trace : public PinObserver {
+    public:
+        Trace(FILE *out, CamperBoard &board);
+
+        virtual void outputChanged(uint8_t pin, bool level);
+        virtual void sleeping();
+
+        // Picks up LCD changes, called after every loop() pass and before
+        // the CPU sleeps
+        void poll();
+        void mark(const std::string &text);
+
+        unsigned long lines() const;
+
+    private:
+        FILE *out;
+        CamperBoard &board;
+        unsigned long lcdRevision;
+        std::string lcdLines[2];
+        int backlight;
+        unsigned long count;
+
+        void write(const char *signal, const std::string &value);
+    };
+
+}
+
+#endif
@@ -0,0 +1,87 @@
+//
+// Runs the controller sketch against the simulated board on the virtual
+// clock, for profiling setup() and loop() with native tools:
+//
+//   camper_host [--seconds N] [--loop-us N] [--profile]
+//
+// Passes that do not wait on anything still cost CPU time on the Uno,
+// --loop-us is how much virtual time each of them is charged. --profile
+// asks a LOOP_PROFILER build for its section timings at the end.
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <Arduino.h>
+#include "SimCore.h"
+#include "CamperBoard.h"
+
+
+namespace {
+
+    double wallSeconds() {
+        timespec ts;
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        return ts.tv_sec + ts.tv_nsec / 1e9;
+    }
+
+    void usage(const char *name) {
+        fprintf(stderr, "usage: %s [--seconds N] [--loop-us N] [--profile]\n", name);
+    }
+
+}
+
+
+int main(int argc, char **argv) {
+    unsigned long seconds = 3600;
+    unsigned long loopUs = 100;
+    bool profile = false;
+
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--seconds") && i + 1 < argc) {
+            seconds = strtoul(argv[++i], NULL, 10);
+        } else if (!strcmp(argv[i], "--loop-us") && i + 1 < argc) {
+            loopUs = strtoul(argv[++i], NULL, 10);
+        } else if (!strcmp(argv[i], "--profile")) {
+            profile = true;
+        } else {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+
+    sim::CamperBoard board;
+
+    double start = wallSeconds();
+    setup();
+    uint64_t end = sim::now() + (uint64_t) seconds * 1000000;
+    unsigned long passes = 0;
+
+    while (sim::now() < end) {
+        uint64_t before = sim::now();
+        loop();
+        if (sim::now() == before)
+            sim::advance(loopUs);
+        passes++;
+    }
+    double elapsed = wallSeconds() - start;
+
+    printf("simulated %lu s, %lu loop passes in %.3f s wall, %.1f ns/pass\n",
+           seconds, passes, elapsed, passes ? elapsed * 1e9 / passes : 0.0);
+    printf("lcd: \"%s\" / \"%s\", %lu I2C bytes in %lu transactions\n",
+           board.lcd().line(0).c_str(), board.lcd().line(1).c_str(),
+           board.lcd().i2cBytes(), board.lcd().transactions());
+    printf("1-wire: %lu resets, %lu slots, %lu us busy\n",
+           board.oneWire().resets(), board.oneWire().slots(),
+           (unsigned long) board.oneWire().busMicros());
+    printf("longest interrupts off: %lu us\n", (unsigned long) sim::maxInterruptsOffUs());
+
+    if (profile) {
+        // Same request the sketch answers on the real Serial port
+        sim::queueSerialInput("p");
+        loop();
+    }
+    return 0;
+}
@@ -0,0 +1,201 @@
+//
+// Replays a scenario (see Scenario.h) against the controller on the
+// virtual clock and writes a trace of its outputs:
+//
+//   camper_sim scenario.scn [--trace file] [--tick-ms N] [--until time]
+//                           [--eeprom file]
+//   camper_sim --dump-fsm
+//
+// loop() runs once per tick of virtual time, or longer when the pass itself
+// waited, so hours of operation take a fraction of a second and every run
+// of the same build and scenario produces the same trace. --eeprom loads
+// the EEPROM cells from the file, when it exists, and saves them at the end.
+// --dump-fsm prints the alarm controller's transition table, with the
+// state and event pairs it has no row for.
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <Arduino.h>
+#include "SimCore.h"
+#include "CamperBoard.h"
+#include "Scenario.h"
+#include "Trace.h"
+#include "AlarmTable/AlarmTable.h"
+
+
+namespace {
+
+    double wallSeconds() {
+        timespec ts;
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        return ts.tv_sec + ts.tv_nsec / 1e9;
+    }
+
+    void usage(const char *name) {
+        fprintf(stderr, "usage: %s scenario [--trace file] [--tick-ms N] [--until time] [--eeprom file]\n"
+                        "       %s --dump-fsm\n", name, name);
+    }
+
+    const char *stateName(int state) {
+#define STATE_NAME(state, activity) #state,
+        static const char *const names[] = {ALARM_STATES(STATE_NAME)};
+#undef STATE_NAME
+        return names[state];
+    }
+
+    const char *eventName(int event) {
+#define EVENT_NAME(event) #event,
+        static const char *const names[] = {ALARM_EVENTS(EVENT_NAME)};
+#undef EVENT_NAME
+        return names[event];
+    }
+
+    const char *orNone(const char *name) {
+        return strcmp(name, "nullptr") ? name : "-";
+    }
+
+    void dumpFsm() {
+        printf("states:\n");
+#define PRINT_STATE(state, activity) \
+        printf("  %-10s every pass: %s\n", #state, orNone(#activity));
+        ALARM_STATES(PRINT_STATE)
+#undef PRINT_STATE
+
+        printf("transitions:\n");
+        bool handled[AlarmTable::ALARM + 1][AlarmTable::TICK + 1] = {};
+#define PRINT_ROW(from, event, to, guard, action) \
+        handled[AlarmTable::from][AlarmTable::event] = true; \
+        printf("  %-10s %-18s -> %-10s if %-18s do %s\n", #from, #event, #to, orNone(#guard), orNone(#action));
+        ALARM_TRANSITIONS(PRINT_ROW)
+#undef PRINT_ROW
+
+        printf("ignored:\n");
+        for (int state = 0; state <= AlarmTable::ALARM; state++) {
+            printf("  %-10s", stateName(state));
+            for (int event = 0; event <= AlarmTable::TICK; event++) {
+                if (!handled[state][event])
+                    printf(" %s", eventName(event));
+            }
+            printf("\n");
+        }
+    }
+
+    void loadEeprom(const char *path) {
+        FILE *file = fopen(path, "rb");
+        if (file) {
+            fread(sim::eeprom(), 1, sim::eepromSize, file);
+            fclose(file);
+        }
+    }
+
+    bool saveEeprom(const char *path) {
+        FILE *file = fopen(path, "wb");
+        if (!file)
+            return false;
+        bool written = fwrite(sim::eeprom(), 1, sim::eepromSize, file) == sim::eepromSize;
+        return fclose(file) == 0 && written;
+    }
+
+}
+
+
+int main(int argc, char **argv) {
+    const char *scenarioPath = NULL;
+    const char *tracePath = NULL;
+    const char *eepromPath = NULL;
+    uint64_t tickUs = 1000;
+    uint64_t until = 0;
+
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--trace") && i + 1 < argc) {
+            tracePath = argv[++i];
+        } else if (!strcmp(argv[i], "--tick-ms") && i + 1 < argc) {
+            tickUs = strtoul(argv[++i], NULL, 10) * 1000;
+        } else if (!strcmp(argv[i], "--until") && i + 1 < argc) {
+            if (!sim::parseTime(argv[++i], until)) {
+                usage(argv[0]);
+                return 1;
+            }
+        } else if (!strcmp(argv[i], "--dump-fsm")) {
+            dumpFsm();
+            return 0;
+        } else if (!strcmp(argv[i], "--eeprom") && i + 1 < argc) {
+            eepromPath = argv[++i];
+        } else if (argv[i][0] != '-' && !scenarioPath) {
+            scenarioPath = argv[i];
+        } else {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+    if (!scenarioPath || tickUs == 0) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    sim::Scenario scenario;
+    std::string error;
+    if (!scenario.load(scenarioPath, error)) {
+        fprintf(stderr, "%s: %s\n", scenarioPath, error.c_str());
+        return 1;
+    }
+    uint64_t end = until ? until : scenario.endTime();
+
+    FILE *out = tracePath ? fopen(tracePath, "w") : stdout;
+    if (!out) {
+        perror(tracePath);
+        return 1;
+    }
+
+    if (eepromPath)
+        loadEeprom(eepromPath);
+
+    sim::CamperBoard board;
+    sim::Trace trace(out, board);
+    std::string marks;
+    unsigned long passes = 0;
+    double start = wallSeconds();
+
+    scenario.apply(0, board, marks);
+    if (!marks.empty()) {
+        trace.mark(marks);
+        marks.clear();
+    }
+    setup();
+    trace.poll();
+
+    while (sim::now() < end) {
+        scenario.apply(sim::now(), board, marks);
+        if (!marks.empty()) {
+            trace.mark(marks);
+            marks.clear();
+        }
+
+        // Idle sleep in loop() ends at the next scenario action
+        uint64_t tick = sim::now() + tickUs;
+        sim::setNextInputChange(scenario.nextTime());
+        loop();
+        trace.poll();
+        passes++;
+
+        if (scenario.nextTime() < tick)
+            tick = scenario.nextTime();
+        if (sim::now() < tick)
+            sim::advance(tick - sim::now());
+    }
+    double elapsed = wallSeconds() - start;
+
+    if (out != stdout)
+        fclose(out);
+    if (eepromPath && !saveEeprom(eepromPath)) {
+        perror(eepromPath);
+        return 1;
+    }
+    fprintf(stderr, "%s: %.3f s simulated in %.3f s, %lu loop passes, %lu trace lines, %lu EEPROM writes\n",
+            scenarioPath, end / 1e6, elapsed, passes, trace.lines(), sim::eepromWrites());
+    return 0;
+}
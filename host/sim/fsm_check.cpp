@@ -0,0 +1,160 @@
+//
+// Walks every state and event pair of the alarm controller's transition
+// table, with the guard passing and failing, and compares the next state,
+// the guard asked and the action run with the expected ones below:
+//
+//   fsm_check
+//
+// The table is ALARM_TRANSITIONS itself, dispatched through StateMachine,
+// with the guards and actions replaced by stubs that record their name. A
+// guard or action added to the table without a stub here calls the
+// controller's own and shows up as a mismatch. The exit status is 1 when
+// any pair differs.
+//
+
+#include <stdio.h>
+#include <string.h>
+
+#include "AlarmTable/AlarmTable.h"
+
+
+namespace check {
+
+    bool guardPasses;
+    const char *guardAsked;
+    const char *actionRun;
+
+#define GUARD_STUB(name) bool name() { guardAsked = #name; return guardPasses; }
+#define ACTION_STUB(name) void name() { actionRun = #name; }
+    GUARD_STUB(isArmingKey)
+    GUARD_STUB(countdownElapsed)
+    GUARD_STUB(pinEntered)
+    GUARD_STUB(unlockTimeElapsed)
+    GUARD_STUB(alarmTimeElapsed)
+    ACTION_STUB(startCountdown)
+    ACTION_STUB(startAlarm)
+    ACTION_STUB(startUnlocking)
+    ACTION_STUB(disarmAlarm)
+    ACTION_STUB(silenceAlarm)
+#undef GUARD_STUB
+#undef ACTION_STUB
+
+    // The alarm table's rows, with the names above found before the real ones
+    struct StubTable : AlarmTable {
+#define STUB_ROW(from, event, to, guard, action) {from, event, to, guard, action},
+        static constexpr Transition<State, Event> transitions[] = {
+            ALARM_TRANSITIONS(STUB_ROW)
+        };
+#undef STUB_ROW
+        static constexpr size_t rows = sizeof(transitions) / sizeof(transitions[0]);
+    };
+    constexpr Transition<StubTable::State, StubTable::Event> StubTable::transitions[];
+
+    typedef AlarmTable A;
+
+    // What the controller must do for a state and event: the guard it asks
+    // (or "-"), where it goes and what it runs when the guard passes, and
+    // where it stays when it fails
+    struct Expected {
+        A::State from;
+        A::Event event;
+        const char *guard;
+        A::State to;
+        const char *action;
+        A::State otherwise;
+    };
+
+    const Expected expected[] = {
+        {A::NORMAL,    A::KEY_PRESSED,       "isArmingKey",       A::ARMING,    "startCountdown", A::NORMAL},
+        {A::NORMAL,    A::FRONT_DOOR_OPENED, "-",                 A::NORMAL,    "-",              A::NORMAL},
+        {A::NORMAL,    A::SIDE_DOOR_OPENED,  "-",                 A::NORMAL,    "-",              A::NORMAL},
+        {A::NORMAL,    A::TICK,              "-",                 A::NORMAL,    "-",              A::NORMAL},
+
+        {A::ARMING,    A::KEY_PRESSED,       "-",                 A::NORMAL,    "-",              A::NORMAL},
+        {A::ARMING,    A::FRONT_DOOR_OPENED, "-",                 A::ARMING,    "-",              A::ARMING},
+        {A::ARMING,    A::SIDE_DOOR_OPENED,  "-",                 A::ARMING,    "-",              A::ARMING},
+        {A::ARMING,    A::TICK,              "countdownElapsed",  A::ARMED,     "-",              A::ARMING},
+
+        {A::ARMED,     A::KEY_PRESSED,       "pinEntered",        A::NORMAL,    "disarmAlarm",    A::ARMED},
+        {A::ARMED,     A::FRONT_DOOR_OPENED, "-",                 A::UNLOCKING, "startUnlocking", A::UNLOCKING},
+        {A::ARMED,     A::SIDE_DOOR_OPENED,  "-",                 A::ALARM,     "startAlarm",     A::ALARM},
+        {A::ARMED,     A::TICK,              "-",                 A::ARMED,     "-",              A::ARMED},
+
+        {A::UNLOCKING, A::KEY_PRESSED,       "pinEntered",        A::NORMAL,    "disarmAlarm",    A::UNLOCKING},
+        {A::UNLOCKING, A::FRONT_DOOR_OPENED, "-",                 A::UNLOCKING, "-",              A::UNLOCKING},
+        {A::UNLOCKING, A::SIDE_DOOR_OPENED,  "-",                 A::UNLOCKING, "-",              A::UNLOCKING},
+        {A::UNLOCKING, A::TICK,              "unlockTimeElapsed", A::ALARM,     "startAlarm",     A::UNLOCKING},
+
+        {A::ALARM,     A::KEY_PRESSED,       "pinEntered",        A::NORMAL,    "disarmAlarm",    A::ALARM},
+        {A::ALARM,     A::FRONT_DOOR_OPENED, "-",                 A::ALARM,     "-",              A::ALARM},
+        {A::ALARM,     A::SIDE_DOOR_OPENED,  "-",                 A::ALARM,     "-",              A::ALARM},
+        {A::ALARM,     A::TICK,              "alarmTimeElapsed",  A::ARMED,     "silenceAlarm",   A::ALARM},
+    };
+
+    const char *stateName(int state) {
+#define STATE_NAME(state, activity) #state,
+        static const char *const names[] = {ALARM_STATES(STATE_NAME)};
+#undef STATE_NAME
+        return names[state];
+    }
+
+    const char *eventName(int event) {
+#define EVENT_NAME(event) #event,
+        static const char *const names[] = {ALARM_EVENTS(EVENT_NAME)};
+#undef EVENT_NAME
+        return names[event];
+    }
+
+    const Expected *find(int state, int event) {
+        for (size_t i = 0; i < sizeof(expected) / sizeof(expected[0]); i++) {
+            if (expected[i].from == state && expected[i].event == event)
+                return &expected[i];
+        }
+        return NULL;
+    }
+
+    // One dispatch, false and a line on stdout when it differs
+    bool dispatch(const Expected &pair, bool passes) {
+        StateMachine<StubTable> machine(pair.from);
+        guardPasses = passes;
+        guardAsked = "-";
+        actionRun = "-";
+        machine.dispatch(pair.event);
+
+        // A row without a guard is taken either way
+        bool taken = passes || !strcmp(pair.guard, "-");
+        A::State to = taken ? pair.to : pair.otherwise;
+        const char *action = taken ? pair.action : "-";
+        bool ok = machine.state() == to && !strcmp(guardAsked, pair.guard) && !strcmp(actionRun, action);
+        printf("%-10s %-18s guard %-4s %-18s -> %-10s do %s%s\n", stateName(pair.from), eventName(pair.event),
+               passes ? "pass" : "fail", guardAsked, stateName(machine.state()), actionRun,
+               ok ? "" : "  MISMATCH");
+        if (!ok)
+            printf("%53s expected %s -> %s do %s\n", "", pair.guard, stateName(to), action);
+        return ok;
+    }
+
+}
+
+
+int main() {
+    unsigned failures = 0;
+    unsigned pairs = 0;
+
+    for (int state = 0; state <= AlarmTable::ALARM; state++) {
+        for (int event = 0; event <= AlarmTable::TICK; event++) {
+            const check::Expected *pair = check::find(state, event);
+            if (!pair) {
+                printf("%-10s %-18s no expectation\n", check::stateName(state), check::eventName(event));
+                failures++;
+                continue;
+            }
+            failures += !check::dispatch(*pair, true);
+            failures += !check::dispatch(*pair, false);
+            pairs++;
+        }
+    }
+
+    printf("%u state and event pairs, %u mismatches\n", pairs, failures);
+    return failures ? 1 : 0;
+}
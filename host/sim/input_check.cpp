@@ -0,0 +1,138 @@
+//
+// Checks that a chattering door line cannot hold back the edge of another
+// door, for Button's per-instance debounce in both its timed and its
+// integrator mode and for the DoorMonitor ring the controller reads the
+// doors from:
+//
+//   input_check
+//
+// One door line toggles at several rates while a second door opens at
+// several offsets into the controller period. Pin changes are handed to
+// DoorMonitor::pinChange() as they happen, like the PCINT2 interrupt on
+// the Uno, and the events are read every controller period like
+// dispatchDoorEvents() does. The exit status is 1 when the second door's
+// opening is seen later than the debounce time after it happened, or not
+// at all.
+//
+
+#include <stdio.h>
+
+#include <Arduino.h>
+#include "SimCore.h"
+#include "Button/Button.h"
+#include "DoorMonitor/DoorMonitor.h"
+
+#define CHATTER_PIN 3
+#define DOOR_PIN 4
+#define QUIET_PIN 5
+
+// Button's 20 ms, also four ButtonGroup ticks. Button reports the edge on
+// the first sample after 20 ms of a stable level, up to 2 ms later.
+#define DEBOUNCE_MS 20
+#define BUTTON_SLACK_MS 2
+// Integrator mode over the same time at one sample per millisecond
+#define INTEGRATOR_SAMPLES 20
+// How often the controller takes the door events, CONTROLLER_TIME
+#define CONTROLLER_MS 10
+#define STEP_US 100
+
+
+namespace {
+
+    const unsigned long CHATTER_US[] = {300, 1000, 3000, 7000};
+    const unsigned long OPEN_OFFSET_US[] = {0, 2500, 5000, 9900};
+    const uint64_t OPEN_AT_US = 100000;
+    const uint64_t RUN_US = 400000;
+
+    bool chatterLevel(uint64_t now, unsigned long period) {
+        return (now / period) % 2;
+    }
+
+    // Milliseconds from the door opening to Button reporting it, -1 if never
+    long buttonDelay(unsigned long chatterUs, uint64_t openAt, byte integratorSamples) {
+        sim::reset();
+        Button chatter(CHATTER_PIN, LOW, integratorSamples);
+        Button door(DOOR_PIN, LOW, integratorSamples);
+        sim::setInput(DOOR_PIN, LOW);
+
+        for (uint64_t now = 0; now < RUN_US; now += STEP_US, sim::advance(STEP_US)) {
+            sim::setInput(CHATTER_PIN, chatterLevel(now, chatterUs));
+            sim::setInput(DOOR_PIN, now >= openAt);
+            // beenClicked() once per millisecond, like the 1 ms loop() passes
+            if (now % 1000)
+                continue;
+            chatter.beenClicked();
+            if (door.beenClicked() && now >= openAt)
+                return (long) ((now - openAt + 999) / 1000);
+        }
+        return -1;
+    }
+
+    // Milliseconds from the door opening to the controller reading its
+    // event, -1 if the event never arrives or carries the wrong time
+    long monitorDelay(unsigned long chatterUs, uint64_t openAt) {
+        sim::reset();
+        sim::setInput(CHATTER_PIN, LOW);
+        sim::setInput(DOOR_PIN, LOW);
+        sim::setInput(QUIET_PIN, LOW);
+        DoorMonitor doors(bit(CHATTER_PIN) | bit(DOOR_PIN) | bit(QUIET_PIN));
+        doors.begin();
+
+        bool chatter = false;
+        bool open = false;
+        for (uint64_t now = 0; now < RUN_US; now += STEP_US, sim::advance(STEP_US)) {
+            bool nextChatter = chatterLevel(now, chatterUs);
+            bool nextOpen = now >= openAt;
+            if (nextChatter != chatter || nextOpen != open) {
+                chatter = nextChatter;
+                open = nextOpen;
+                sim::setInput(CHATTER_PIN, chatter);
+                sim::setInput(DOOR_PIN, open);
+                doors.pinChange();
+            }
+
+            if (now % (CONTROLLER_MS * 1000))
+                continue;
+            DoorEvent event;
+            while (doors.read(event)) {
+                if (event.pin != DOOR_PIN || !event.open)
+                    continue;
+                if (event.time != openAt / 1000)
+                    return -1;
+                return (long) ((now - openAt + 999) / 1000);
+            }
+        }
+        return -1;
+    }
+
+    bool report(const char *what, unsigned long chatterUs, unsigned long offsetUs, long delay, long limit) {
+        bool late = delay < 0 || delay > limit;
+        printf("%-12s %10.1f %10.1f %10s%s\n", what, chatterUs / 1000.0, offsetUs / 1000.0,
+               delay < 0 ? "never" : String(delay).c_str(), late ? "  LATE" : "");
+        return late;
+    }
+
+}
+
+
+int main() {
+    unsigned failures = 0;
+
+    printf("%-12s %10s %10s %10s\n", "input", "chatter ms", "offset ms", "seen ms");
+    for (size_t c = 0; c < sizeof(CHATTER_US) / sizeof(CHATTER_US[0]); c++) {
+        for (size_t o = 0; o < sizeof(OPEN_OFFSET_US) / sizeof(OPEN_OFFSET_US[0]); o++) {
+            uint64_t openAt = OPEN_AT_US + OPEN_OFFSET_US[o];
+            failures += report("Button", CHATTER_US[c], OPEN_OFFSET_US[o],
+                               buttonDelay(CHATTER_US[c], openAt, 0), DEBOUNCE_MS + BUTTON_SLACK_MS);
+            failures += report("Integrator", CHATTER_US[c], OPEN_OFFSET_US[o],
+                               buttonDelay(CHATTER_US[c], openAt, INTEGRATOR_SAMPLES),
+                               DEBOUNCE_MS + BUTTON_SLACK_MS);
+            failures += report("DoorMonitor", CHATTER_US[c], OPEN_OFFSET_US[o],
+                               monitorDelay(CHATTER_US[c], openAt), DEBOUNCE_MS);
+        }
+    }
+
+    printf("%u late of %u\n", failures,
+           (unsigned) (3 * sizeof(CHATTER_US) / sizeof(CHATTER_US[0]) * sizeof(OPEN_OFFSET_US) / sizeof(OPEN_OFFSET_US[0])));
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,394 @@
+//
+// Runs the OneWire and DallasTemperature calls the controller relies on
+// against simulated sensors and prints what each one cost on the bus:
+//
+//   onewire_bench [--ds18b20 N] [--ds18s20 N] [--parasite]
+//   onewire_bench --service MINUTES [--parasite]
+//
+// Resets, slots and bus time come from the bus model and only change when
+// the protocol code does, so they can be compared between builds. The
+// elapsed column is virtual time, including conversion waits. --parasite
+// powers every sensor from the data line. The exit status is 1 when a
+// temperature read back does not match the one the sensor was given.
+//
+// --service runs TemperatureService with the camper's four sensors for
+// MINUTES of virtual time, once at fixed and once at adaptive resolution,
+// with the temperatures moving like they do on a trip: a slow cabin with
+// the door opened halfway, a cycling fridge, outside drifting and the
+// battery bay warming up to its limit while charging. The outside sensor
+// browns out a third of the way in, between two cycles, and comes back at
+// the resolution saved in its EEPROM. It prints what each run cost on the
+// bus and how long the bus had a conversion outstanding.
+//
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+#include <Arduino.h>
+#include "SimCore.h"
+#include "OneWireBus.h"
+#include "OneWire/OneWire.h"
+#include "DallasTemperature/DallasTemperature.h"
+#include "TemperatureService/TemperatureService.h"
+
+#define BUS_PIN 17
+
+
+namespace {
+
+    void usage(const char *name) {
+        fprintf(stderr, "usage: %s [--ds18b20 N] [--ds18s20 N] [--parasite]\n"
+                        "       %s --service MINUTES [--parasite]\n", name, name);
+    }
+
+    // Counters at the start of an operation, printed as one row at its end
+    class Measure {
+    public:
+        Measure(const sim::OneWireBus &bus, const char *name)
+        : bus(bus), name(name), resets(bus.resets()), slots(bus.slots()),
+          busMicros(bus.busMicros()), start(sim::now()) {
+        }
+
+        ~Measure() {
+            printf("%-28s %7lu %8lu %11.3f %11.3f\n", name,
+                   bus.resets() - resets, bus.slots() - slots,
+                   (bus.busMicros() - busMicros) / 1000.0,
+                   (sim::now() - start) / 1000.0);
+        }
+
+    private:
+        const sim::OneWireBus &bus;
+        const char *name;
+        unsigned long resets;
+        unsigned long slots;
+        uint64_t busMicros;
+        uint64_t start;
+    };
+
+    // Spread over the range the camper sees, with fractions both models
+    // have to round
+    float sensorTemperature(size_t index) {
+        return -18.3f + 7.71f * index;
+    }
+
+    sim::Ds18b20 *findSensor(const std::vector<sim::Ds18b20 *> &sensors, const uint8_t *address) {
+        for (size_t i = 0; i < sensors.size(); i++) {
+            if (!memcmp(sensors[i]->address(), address, 8))
+                return sensors[i];
+        }
+        return NULL;
+    }
+
+    size_t checkReadings(const char *what, const std::vector<float> &readings,
+                         const std::vector<sim::Ds18b20 *> &sensors, float tolerance) {
+        size_t bad = 0;
+        for (size_t i = 0; i < sensors.size(); i++) {
+            if (fabsf(readings[i] - sensors[i]->getTemperature()) > tolerance) {
+                printf("  %s: sensor %u read %.4f, expected %.4f\n", what, (unsigned) i,
+                       readings[i], sensors[i]->getTemperature());
+                bad++;
+            }
+        }
+        return bad;
+    }
+
+    // The camper's sensors, in the order src/main.cpp reads them
+    const TemperatureService::Config SERVICE_SENSORS[] = {
+            {12, 15000, 5, 30},     // cabin
+            {11, 30000, 0, 8},      // fridge
+            {10, 60000, -5, 40},    // outside
+            {11, 30000, 0, 45}      // battery bay
+    };
+    const uint8_t SERVICE_SENSOR_COUNT = sizeof(SERVICE_SENSORS) / sizeof(SERVICE_SENSORS[0]);
+    const char *const SERVICE_SENSOR_NAMES[] = {"cabin", "fridge", "outside", "battery bay"};
+
+    float serviceTemperature(uint8_t sensor, double minutes, double total) {
+        switch (sensor) {
+            case 0:
+                // Door open for a minute halfway, then the heater catches up
+                if (minutes >= total / 2 && minutes < total / 2 + 1)
+                    return (float) (21 - 4 * (minutes - total / 2));
+                if (minutes >= total / 2 + 1 && minutes < total / 2 + 5)
+                    return (float) (17 + (minutes - total / 2 - 1));
+                return (float) (21 + 0.5 * sin(minutes / 10));
+            case 1:
+                // Compressor cycle, 1 to 7 C every 20 minutes
+                return (float) (4 + 3 * sin(minutes * 2 * M_PI / 20));
+            case 2:
+                return (float) (12 + minutes / 60);
+            default:
+                return (float) (15 + 28 * minutes / total);
+        }
+    }
+
+    struct ServiceRun {
+        unsigned long readings;
+        unsigned long resolutionChanges;
+        unsigned long resets;
+        unsigned long slots;
+        uint64_t busMicros;
+        uint64_t convertingMicros;
+        double bits[TemperatureService::maxSensors];
+        float maxError[TemperatureService::maxSensors];
+    };
+
+    ServiceRun runService(double minutes, bool parasite, bool adaptive) {
+        const uint64_t step = 10000;
+        ServiceRun run;
+        memset(&run, 0, sizeof(run));
+
+        sim::reset();
+        sim::OneWireBus bus(BUS_PIN);
+        // The controller board's serials, which search in this order
+        const uint8_t serials[] = {0x80, 0x40, 0xC0, 0x20};
+        std::vector<sim::Ds18b20 *> sensors;
+        for (uint8_t i = 0; i < SERVICE_SENSOR_COUNT; i++) {
+            sensors.push_back(new sim::Ds18b20(serials[i], parasite));
+            sensors[i]->setTemperature(serviceTemperature(i, 0, minutes));
+            bus.add(sensors[i]);
+        }
+
+        OneWire oneWire(BUS_PIN);
+        DallasTemperature dallas(&oneWire);
+        TemperatureService service(dallas, SERVICE_SENSORS, SERVICE_SENSOR_COUNT);
+        service.begin();
+        service.setAdaptive(adaptive);
+
+        uint64_t start = sim::now();
+        uint64_t end = start + (uint64_t) (minutes * 60e6);
+        uint8_t resolution[TemperatureService::maxSensors];
+        float last[TemperatureService::maxSensors];
+        for (uint8_t i = 0; i < SERVICE_SENSOR_COUNT; i++) {
+            resolution[i] = service.getResolution(i);
+            last[i] = service.getTemperature(i);
+        }
+
+        bool brownedOut = false;
+        while (sim::now() < end) {
+            double at = (sim::now() - start) / 60e6;
+            for (uint8_t i = 0; i < SERVICE_SENSOR_COUNT; i++)
+                sensors[i]->setTemperature(serviceTemperature(i, at, minutes));
+            if (!brownedOut && at >= minutes / 3 && !service.isConverting()) {
+                sensors[2]->powerLoss();
+                brownedOut = true;
+            }
+
+            uint64_t before = sim::now();
+            bool converting = service.isConverting();
+            service.update();
+            sim::advance(step);
+            if (converting)
+                run.convertingMicros += sim::now() - before;
+
+            for (uint8_t i = 0; i < SERVICE_SENSOR_COUNT; i++) {
+                run.bits[i] += service.getResolution(i) * (double) (sim::now() - before);
+                if (service.getResolution(i) != resolution[i]) {
+                    resolution[i] = service.getResolution(i);
+                    run.resolutionChanges++;
+                }
+                float reading = service.getTemperature(i);
+                if (reading != last[i]) {
+                    last[i] = reading;
+                    run.readings++;
+                }
+                if (reading != DEVICE_DISCONNECTED_C)
+                    run.maxError[i] = max(run.maxError[i], fabsf(reading - sensors[i]->getTemperature()));
+            }
+        }
+
+        for (uint8_t i = 0; i < SERVICE_SENSOR_COUNT; i++) {
+            run.bits[i] /= (double) (sim::now() - start);
+            delete sensors[i];
+        }
+        run.resets = bus.resets();
+        run.slots = bus.slots();
+        run.busMicros = bus.busMicros();
+        return run;
+    }
+
+    double saved(double fixed, double adaptive) {
+        return fixed > 0 ? 100 * (fixed - adaptive) / fixed : 0;
+    }
+
+    int serviceReport(double minutes, bool parasite) {
+        ServiceRun fixed = runService(minutes, parasite, false);
+        ServiceRun adaptive = runService(minutes, parasite, true);
+
+        printf("TemperatureService, %.0f min, %u DS18B20, %s power\n\n", minutes,
+               SERVICE_SENSOR_COUNT, parasite ? "parasite" : "external");
+        printf("%-28s %11s %11s %8s\n", "", "fixed", "adaptive", "saved");
+        printf("%-28s %11lu %11lu\n", "readings changed", fixed.readings, adaptive.readings);
+        printf("%-28s %11lu %11lu\n", "resolution changes", fixed.resolutionChanges, adaptive.resolutionChanges);
+        printf("%-28s %11lu %11lu %7.1f%%\n", "resets", fixed.resets, adaptive.resets,
+               saved(fixed.resets, adaptive.resets));
+        printf("%-28s %11lu %11lu %7.1f%%\n", "slots", fixed.slots, adaptive.slots,
+               saved(fixed.slots, adaptive.slots));
+        printf("%-28s %11.1f %11.1f %7.1f%%\n", "bus ms", fixed.busMicros / 1000.0,
+               adaptive.busMicros / 1000.0, saved(fixed.busMicros, adaptive.busMicros));
+        printf("%-28s %11.1f %11.1f %7.1f%%\n", "converting ms", fixed.convertingMicros / 1000.0,
+               adaptive.convertingMicros / 1000.0, saved(fixed.convertingMicros, adaptive.convertingMicros));
+
+        printf("\n%-28s %11s %11s\n", "average bits, max error C", "fixed", "adaptive");
+        for (uint8_t i = 0; i < SERVICE_SENSOR_COUNT; i++) {
+            printf("%-28s %5.2f %5.3f %5.2f %5.3f\n", SERVICE_SENSOR_NAMES[i],
+                   fixed.bits[i], fixed.maxError[i], adaptive.bits[i], adaptive.maxError[i]);
+        }
+        return 0;
+    }
+
+}
+
+
+int main(int argc, char **argv) {
+    unsigned long ds18b20Count = 4;
+    unsigned long ds18s20Count = 0;
+    bool parasite = false;
+    double serviceMinutes = 0;
+
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--service") && i + 1 < argc) {
+            serviceMinutes = strtod(argv[++i], NULL);
+            if (serviceMinutes <= 0) {
+                usage(argv[0]);
+                return 1;
+            }
+        } else if (!strcmp(argv[i], "--ds18b20") && i + 1 < argc) {
+            ds18b20Count = strtoul(argv[++i], NULL, 10);
+        } else if (!strcmp(argv[i], "--ds18s20") && i + 1 < argc) {
+            ds18s20Count = strtoul(argv[++i], NULL, 10);
+        } else if (!strcmp(argv[i], "--parasite")) {
+            parasite = true;
+        } else {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+    if (serviceMinutes > 0)
+        return serviceReport(serviceMinutes, parasite);
+    if (ds18b20Count + ds18s20Count == 0 || ds18b20Count + ds18s20Count > 64) {
+        fprintf(stderr, "between 1 and 64 sensors\n");
+        return 1;
+    }
+
+    sim::reset();
+    sim::OneWireBus bus(BUS_PIN);
+    std::vector<sim::Ds18b20 *> sensors;
+    for (unsigned long i = 0; i < ds18b20Count + ds18s20Count; i++) {
+        // Serials spread over the byte so the search has to branch
+        uint8_t serial = (uint8_t) (i * 0x9D + 1);
+        sim::Ds18b20 *sensor = i < ds18b20Count ? new sim::Ds18b20(serial, parasite)
+                                                : new sim::Ds18s20(serial, parasite);
+        sensor->setTemperature(sensorTemperature(i));
+        bus.add(sensor);
+        sensors.push_back(sensor);
+    }
+
+    OneWire oneWire(BUS_PIN);
+    DallasTemperature dallas(&oneWire);
+    std::vector<float> readings(sensors.size());
+    DeviceAddress addresses[64];
+    size_t bad = 0;
+
+    printf("%lu DS18B20, %lu DS18S20, %s power\n\n", ds18b20Count, ds18s20Count,
+           parasite ? "parasite" : "external");
+    printf("%-28s %7s %8s %11s %11s\n", "operation", "resets", "slots", "bus ms", "elapsed ms");
+
+    {
+        Measure m(bus, "begin");
+        dallas.begin();
+    }
+    if (dallas.getDeviceCount() != sensors.size()) {
+        printf("  begin: found %u of %u sensors\n", dallas.getDeviceCount(), (unsigned) sensors.size());
+        bad++;
+    }
+    // The library numbers the sensors in search order, by address
+    std::vector<sim::Ds18b20 *> found(sensors.size());
+    for (size_t i = 0; i < sensors.size(); i++) {
+        dallas.getAddress(addresses[i], (uint8_t) i);
+        found[i] = findSensor(sensors, addresses[i]);
+        if (!found[i]) {
+            printf("  getAddress: no sensor at index %u\n", (unsigned) i);
+            return 1;
+        }
+    }
+
+    {
+        Measure m(bus, "requestTemperatures");
+        dallas.requestTemperatures();
+    }
+    {
+        Measure m(bus, "getTempCByIndex, all");
+        for (size_t i = 0; i < sensors.size(); i++)
+            readings[i] = dallas.getTempCByIndex((uint8_t) i);
+    }
+    bad += checkReadings("getTempCByIndex", readings, found, 1.0f / 16);
+    {
+        Measure m(bus, "getTempC, all");
+        for (size_t i = 0; i < sensors.size(); i++)
+            readings[i] = dallas.getTempC(addresses[i]);
+    }
+    bad += checkReadings("getTempC", readings, found, 1.0f / 16);
+
+    {
+        Measure m(bus, "setResolution 9");
+        dallas.setResolution(9);
+    }
+    {
+        Measure m(bus, "requestTemperatures, 9 bit");
+        dallas.requestTemperatures();
+    }
+    {
+        Measure m(bus, "getTempC, all, 9 bit");
+        for (size_t i = 0; i < sensors.size(); i++)
+            readings[i] = dallas.getTempC(addresses[i]);
+    }
+    bad += checkReadings("getTempC 9 bit", readings, found, 1.0f / 2);
+
+    {
+        Measure m(bus, "search ROM, whole bus");
+        DeviceAddress address;
+        oneWire.reset_search();
+        while (oneWire.search(address))
+            ;
+    }
+
+    // Only the first sensor is over its high alarm limit. The power-on
+    // limits (75 and 70 C) put everything cooler in alarm.
+    {
+        Measure m(bus, "set alarm limits, all");
+        for (size_t i = 0; i < sensors.size(); i++) {
+            int8_t high = i == 0 ? (int8_t) floorf(found[0]->getTemperature() - 1) : 125;
+            dallas.setHighAlarmTemp(addresses[i], high);
+            dallas.setLowAlarmTemp(addresses[i], -55);
+        }
+    }
+    dallas.requestTemperatures();
+    unsigned alarms = 0;
+    {
+        Measure m(bus, "alarm search");
+        DeviceAddress address;
+        dallas.resetAlarmSearch();
+        while (dallas.alarmSearch(address)) {
+            if (memcmp(address, addresses[0], 8))
+                bad++;
+            alarms++;
+        }
+    }
+    if (alarms != 1) {
+        printf("  alarm search: %u sensors, expected 1\n", alarms);
+        bad++;
+    }
+
+    unsigned long starved = 0;
+    for (size_t i = 0; i < sensors.size(); i++) {
+        starved += sensors[i]->starvedConversions();
+        delete sensors[i];
+    }
+    printf("\ntotal %lu resets, %lu slots, %.3f ms bus time, %lu starved conversions\n",
+           bus.resets(), bus.slots(), bus.busMicros() / 1000.0, starved);
+    printf("%s\n", bad ? "readings do not match" : "readings match");
+    return bad ? 1 : 0;
+}
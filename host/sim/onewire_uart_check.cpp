@@ -0,0 +1,170 @@
+//
+// Runs the USART0 1-Wire transport against the sensor models, with the bus
+// wired to RX and TX the way OneWireUart.h describes, on the host core's
+// USART0 emulation:
+//
+//   onewire_uart_check
+//
+// Finds and reads DS18B20 and DS18S20 sensors through DallasTemperature,
+// checks that an empty bus gives no presence, and that a bus held low
+// ends a transaction with ONEWIRE_BUS_ERROR instead of reading zeros,
+// which a scratchpad CRC check would take. The exit status is 1 when any
+// check fails.
+//
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <Arduino.h>
+#include "SimCore.h"
+#include "OneWireBus.h"
+#include "OneWire/OneWire.h"
+#include "DallasTemperature/DallasTemperature.h"
+
+#if !ONEWIRE_UART
+#error "onewire_uart_check is built with ONEWIRE_UART=1"
+#endif
+
+#define RXD_PIN 0
+#define TXD_PIN 1
+
+
+namespace {
+
+    // The board between the USART and the bus: TX pulls the bus low
+    // through a diode and never drives it high, RX reads the bus. From
+    // shortFrom on the bus is held low, like a pinched cable.
+    class UartWiring : public sim::PinDevice {
+    public:
+        explicit UartWiring(sim::OneWireBus &bus)
+        : bus(bus), shortFrom(UINT64_MAX) {
+            sim::attach(RXD_PIN, this);
+            sim::attach(TXD_PIN, this);
+        }
+
+        virtual void pinChanged(uint8_t pin, bool output, bool level) {
+            if (pin == TXD_PIN)
+                bus.pinChanged(pin, output && !level, false);
+        }
+
+        virtual int pinLevel(uint8_t pin) {
+            if (sim::now() >= shortFrom)
+                return 0;
+            if (sim::isOutput(TXD_PIN) && !sim::outputLevel(TXD_PIN))
+                return 0;
+            return bus.pinLevel(pin);
+        }
+
+        sim::OneWireBus &bus;
+        uint64_t shortFrom;
+    };
+
+    unsigned failures;
+
+    void check(bool ok, const char *what) {
+        printf("%-56s %s\n", what, ok ? "ok" : "FAILED");
+        if (!ok)
+            failures++;
+    }
+
+    void readSensors() {
+        sim::reset();
+        sim::OneWireBus bus(RXD_PIN);
+        UartWiring wiring(bus);
+        sim::Ds18b20 first(0x11);
+        sim::Ds18b20 second(0x9E);
+        sim::Ds18s20 third(0x2B);
+        sim::Ds18b20 *sensors[] = {&first, &second, &third};
+        const float temperatures[] = {-18.3f, 4.5625f, 36.5f};
+        for (uint8_t i = 0; i < 3; i++) {
+            sensors[i]->setTemperature(temperatures[i]);
+            bus.add(sensors[i]);
+        }
+
+        OneWire oneWire(RXD_PIN);
+        DallasTemperature dallas(&oneWire);
+        dallas.begin();
+        check(dallas.getDeviceCount() == 3, "search finds the three sensors");
+
+        dallas.requestTemperatures();
+        bool match = true;
+        for (uint8_t i = 0; i < dallas.getDeviceCount(); i++) {
+            DeviceAddress address;
+            dallas.getAddress(address, i);
+            for (uint8_t s = 0; s < 3; s++) {
+                if (!memcmp(address, sensors[s]->address(), 8) &&
+                    fabsf(dallas.getTempC(address) - sensors[s]->getTemperature()) > 1.0f / 16)
+                    match = false;
+            }
+        }
+        check(match, "temperatures read back match");
+        check(bus.resets() > 0 && sim::maxInterruptsOffUs() < 100, "slots run from the RX interrupt");
+    }
+
+    void emptyBus() {
+        sim::reset();
+        sim::OneWireBus bus(RXD_PIN);
+        UartWiring wiring(bus);
+
+        OneWire oneWire(RXD_PIN);
+        check(oneWire.reset() == 0, "empty bus gives no presence");
+    }
+
+    void heldLow() {
+        sim::reset();
+        sim::OneWireBus bus(RXD_PIN);
+        UartWiring wiring(bus);
+        sim::Ds18b20 sensor(0x11);
+        sensor.setTemperature(21.0f);
+        bus.add(&sensor);
+
+        OneWire oneWire(RXD_PIN);
+        DallasTemperature dallas(&oneWire);
+        dallas.begin();
+        DeviceAddress address;
+        dallas.getAddress(address, 0);
+
+        // Held low after the read command: the read must not pass the CRC
+        oneWire.reset();
+        oneWire.select(address);
+        oneWire.write(0xBE);
+        wiring.shortFrom = sim::now();
+        uint8_t scratchPad[9];
+        oneWire.read_bytes(scratchPad, sizeof(scratchPad));
+        check(OneWire::crc8(scratchPad, 8) != scratchPad[8], "scratchpad read on a bus held low fails its CRC");
+
+        OneWireUart uart;
+        uart.begin(RXD_PIN);
+        uint8_t in[2] = {0x5A, 0x5A};
+        OneWireTransaction transaction;
+        transaction.flags = 0;
+        transaction.out = 0;
+        transaction.writeBits = 0;
+        transaction.in = in;
+        transaction.readBits = 16;
+        transaction.done = 0;
+        transaction.context = 0;
+        check(uart.run(transaction) == ONEWIRE_BUS_ERROR && in[0] == 0xFF && in[1] == 0xFF,
+              "read slots on a bus held low end in ONEWIRE_BUS_ERROR");
+
+        transaction.flags = ONEWIRE_RESET;
+        transaction.readBits = 0;
+        check(uart.run(transaction) == ONEWIRE_NO_PRESENCE, "reset on a bus held low gives no presence");
+
+        // Back to the transport inside oneWire, begin() takes the interrupt
+        oneWire.begin(RXD_PIN);
+        check(dallas.getTempC(address) == DEVICE_DISCONNECTED_C, "sensor on a bus held low reads as disconnected");
+    }
+
+}
+
+
+int main() {
+    readSensors();
+    emptyBus();
+    heldLow();
+
+    printf("%u failed\n", failures);
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,127 @@
+//
+// Created by rafal on 17.10.2026.
+//
+
+#include "AdcSampler.h"
+
+
+#if ADC_SAMPLER_ISR
+static AdcSampler *runningSampler = nullptr;
+
+ISR(ADC_vect) {
+    if (runningSampler != nullptr)
+        runningSampler->conversionComplete(ADC);
+}
+
+
+static byte adcChannel(byte pin) {
+    return pin >= A0 ? pin - A0 : pin;
+}
+#endif
+
+
+AdcSampler::AdcSampler(const byte *pins, byte count)
+: pins(pins), count(count > channelMax ? channelMax : count) {
+    memset((void *) results, 0, sizeof(results));
+}
+
+
+void AdcSampler::begin() {
+#if ADC_SAMPLER_ISR
+    runningSampler = this;
+    conversion = 0;
+    sum = 0;
+
+    for (byte i = 0; i < count; i++)
+        DIDR0 |= _BV(adcChannel(pins[i]));
+
+    /* AVcc reference like analogRead(), clock 16 MHz / 128, auto trigger
+       with ADCSRB = 0 is free-running */
+    ADMUX = _BV(REFS0) | adcChannel(pins[0]);
+    ADCSRB = 0;
+    ADCSRA = _BV(ADEN) | _BV(ADSC) | _BV(ADATE) | _BV(ADIE) | _BV(ADPS2) | _BV(ADPS1) | _BV(ADPS0);
+#endif
+}
+
+
+void AdcSampler::stop() {
+    /* Turns the ADC off, e.g. before power-down; begin() starts a new set.
+       The last published set stays readable. */
+#if ADC_SAMPLER_ISR
+    ADCSRA = 0;
+#endif
+}
+
+
+void AdcSampler::update() {
+    /* Takes a whole set with blocking reads where there is no interrupt */
+#if !ADC_SAMPLER_ISR
+    for (byte i = 0; i < count; i++) {
+        uint16_t total = 0;
+        for (byte n = 0; n < oversampling; n++)
+            total += analogRead(pins[i]);
+        store(i, total >> 2);
+    }
+#endif
+}
+
+
+void AdcSampler::conversionComplete(uint16_t sample) {
+    /* Interrupt context. The next conversion started when this one ended,
+       so a new ADMUX only applies to the one after it: set the pin for
+       conversion + 2 of the schedule. */
+    byte total = count * oversampling;
+
+    sum += sample;
+    if (conversion % oversampling == oversampling - 1) {
+        store(conversion / oversampling, sum >> 2);
+        sum = 0;
+    }
+
+    conversion++;
+    if (conversion == total)
+        conversion = 0;
+
+#if ADC_SAMPLER_ISR
+    byte ahead = conversion + 1;
+    if (ahead == total)
+        ahead = 0;
+    ADMUX = _BV(REFS0) | adcChannel(pins[ahead / oversampling]);
+#endif
+}
+
+
+void AdcSampler::store(byte index, uint16_t value) {
+    /* The back half is only swapped in once the last pin is done */
+    byte back = front ^ 1;
+    results[back][index] = value;
+    if (index == count - 1) {
+        front = back;
+        published++;
+    }
+}
+
+
+uint16_t AdcSampler::read(byte index) const {
+    /* A 16-bit read is two loads on the AVR, the interrupt must not store
+       in between */
+    uint8_t oldSREG = SREG;
+    noInterrupts();
+    uint16_t value = results[front][index];
+    SREG = oldSREG;
+    return value;
+}
+
+
+void AdcSampler::readSet(uint16_t *out) const {
+    uint8_t oldSREG = SREG;
+    noInterrupts();
+    for (byte i = 0; i < count; i++)
+        out[i] = results[front][i];
+    SREG = oldSREG;
+}
+
+
+byte AdcSampler::sets() const {
+    return published;
+}
@@ -0,0 +1,61 @@
+//
+// Created by rafal on 17.10.2026.
+//
+
+#ifndef ARDUINO_CAMPER_CONTROLLER_ADCSAMPLER_H
+#define ARDUINO_CAMPER_CONTROLLER_ADCSAMPLER_H
+
+#include <Arduino.h>
+
+// Free-running conversions from the ADC interrupt on ATmega328/168.
+// Elsewhere update() takes the same samples with analogRead().
+#if defined(__AVR_ATmega328P__) || defined(__AVR_ATmega328__) || defined(__AVR_ATmega168__)
+#define ADC_SAMPLER_ISR 1
+#else
+#define ADC_SAMPLER_ISR 0
+#endif
+
+
+/* Cycles the ADC over a few analog pins, 16 conversions per pin, and
+   decimates each run of 16 to one 12-bit result (0-4092 for 0-5V). A full
+   set of results is published at once into the idle half of a double
+   buffer. readSet() copies the front half with interrupts off, so its
+   values always come from one set; separate read() calls may straddle a
+   swap and return results from two sets. Neither waits. With the 125 kHz
+   ADC clock a set of three pins takes about 5 ms. analogRead() must not be
+   used while the sampler runs. */
+class AdcSampler {
+public:
+    static const byte channelMax = 4;
+    static const byte oversampling = 16;
+    static const uint16_t fullScale = 4096;
+
+    AdcSampler(const byte *pins, byte count);
+
+    void begin();
+    void stop();
+    void update();
+
+    uint16_t read(byte index) const;
+    // The latest set, one result per pin into out[count]
+    void readSet(uint16_t *out) const;
+    // Number of sets published so far, wraps around
+    byte sets() const;
+
+    void conversionComplete(uint16_t sample);
+
+private:
+    const byte *pins;
+    const byte count;
+
+    volatile uint16_t results[2][channelMax];
+    volatile byte front = 0;
+    volatile byte published = 0;
+
+    uint16_t sum = 0;
+    byte conversion = 0;
+
+    void store(byte index, uint16_t value);
+};
+
+#endif
@@ -0,0 +1,91 @@
+//
+// Created by rafal on 17.10.2026.
+//
+
+#ifndef ARDUINO_CAMPER_CONTROLLER_ALARMTABLE_H
+#define ARDUINO_CAMPER_CONTROLLER_ALARMTABLE_H
+
+#include <Arduino.h>
+
+#include "StateMachine/StateMachine.h"
+
+
+// State and what it does on every pass of loop()
+#define ALARM_STATES(S) \
+    S(NORMAL,    clearRetries) \
+    S(ARMING,    nullptr) \
+    S(ARMED,     blinkArmed) \
+    S(UNLOCKING, blinkUnlocking) \
+    S(ALARM,     soundAlarm)
+
+// KEY_PRESSED carries insertedKey, door events the time of the edge
+#define ALARM_EVENTS(E) \
+    E(KEY_PRESSED) \
+    E(FRONT_DOOR_OPENED) \
+    E(SIDE_DOOR_OPENED) \
+    E(TICK)
+
+// From, event, to, guard, action; the first matching row wins
+#define ALARM_TRANSITIONS(T) \
+    T(NORMAL,    KEY_PRESSED,       ARMING,    isArmingKey,       startCountdown) \
+    T(ARMING,    KEY_PRESSED,       NORMAL,    nullptr,           nullptr) \
+    T(ARMING,    TICK,              ARMED,     countdownElapsed,  nullptr) \
+    T(ARMED,     SIDE_DOOR_OPENED,  ALARM,     nullptr,           startAlarm) \
+    T(ARMED,     FRONT_DOOR_OPENED, UNLOCKING, nullptr,           startUnlocking) \
+    T(ARMED,     KEY_PRESSED,       NORMAL,    pinEntered,        disarmAlarm) \
+    T(UNLOCKING, TICK,              ALARM,     unlockTimeElapsed, startAlarm) \
+    T(UNLOCKING, KEY_PRESSED,       NORMAL,    pinEntered,        disarmAlarm) \
+    T(ALARM,     TICK,              ARMED,     alarmTimeElapsed,  silenceAlarm) \
+    T(ALARM,     KEY_PRESSED,       NORMAL,    pinEntered,        disarmAlarm)
+
+
+// Guards, actions and activities, defined with the rest of the controller
+bool isArmingKey();
+bool countdownElapsed();
+bool pinEntered();
+bool unlockTimeElapsed();
+bool alarmTimeElapsed();
+void startCountdown();
+void startAlarm();
+void startUnlocking();
+void disarmAlarm();
+void silenceAlarm();
+void clearRetries();
+void blinkArmed();
+void blinkUnlocking();
+void soundAlarm();
+
+
+/* The alarm controller for StateMachine. transitions[] and activities[]
+   are defined once, in main.cpp. */
+struct AlarmTable {
+#define ALARM_STATE_ENUM(state, activity) state,
+#define ALARM_EVENT_ENUM(event) event,
+    enum State : uint8_t {
+        ALARM_STATES(ALARM_STATE_ENUM)
+    };
+    enum Event : uint8_t {
+        ALARM_EVENTS(ALARM_EVENT_ENUM)
+    };
+#undef ALARM_STATE_ENUM
+#undef ALARM_EVENT_ENUM
+
+#define ALARM_TRANSITION_ROW(from, event, to, guard, action) {from, event, to, guard, action},
+#define ALARM_STATE_ACTIVITY(state, activity) activity,
+    static constexpr Transition<State, Event> transitions[] = {
+        ALARM_TRANSITIONS(ALARM_TRANSITION_ROW)
+    };
+    static constexpr void (*activities[])() = {
+        ALARM_STATES(ALARM_STATE_ACTIVITY)
+    };
+#undef ALARM_TRANSITION_ROW
+#undef ALARM_STATE_ACTIVITY
+
+    static constexpr size_t rows = sizeof(transitions) / sizeof(transitions[0]);
+};
+
+static_assert(sizeof(AlarmTable::activities) / sizeof(AlarmTable::activities[0]) == AlarmTable::ALARM + 1,
+              "an activity for every alarm state");
+static_assert(rowsReachable<AlarmTable>(), "an alarm table row is hidden by an earlier row without a guard");
+
+#endif
@@ -3,6 +3,16 @@
 #include <Arduino.h>
 #include <Wire.h>
 
+#if LCD_I2C_BURST
+// Bytes one I2C transaction can carry and expander writes per display byte
+#ifdef BUFFER_LENGTH
+#define LCD_BURST_BUFFER BUFFER_LENGTH
+#else
+#define LCD_BURST_BUFFER 32
+#endif
+#define LCD_BURST_PER_SEND 6
+#endif
+
 // When the display powers up, it is configured as follows:
 //
 // 1. Display clear
@@ -176,10 +186,19 @@ void LiquidCrystal_I2C::noAutoscroll(void) {
 // with custom characters
 void LiquidCrystal_I2C::createChar(uint8_t location, uint8_t charmap[]) {
 	location &= 0x7; // we only have 8 locations 0-7
+#if LCD_I2C_BURST
+	burstBegin();
+	burstSend(LCD_SETCGRAMADDR | (location << 3), 0);
+	for (int i=0; i<8; i++) {
+		burstSend(charmap[i], Rs);
+	}
+	burstEnd();
+#else
 	command(LCD_SETCGRAMADDR | (location << 3));
 	for (int i=0; i<8; i++) {
 		write(charmap[i]);
 	}
+#endif
 }
 
 // Turn the (optional) backlight off/on
@@ -208,15 +227,36 @@ inline size_t LiquidCrystal_I2C::write(uint8_t value) {
 	return 1;
 }
 
+size_t LiquidCrystal_I2C::write(const uint8_t *buffer, size_t size) {
+#if LCD_I2C_BURST
+	burstBegin();
+	for (size_t i=0; i<size; i++) {
+		burstSend(buffer[i], Rs);
+	}
+	burstEnd();
+#else
+	for (size_t i=0; i<size; i++) {
+		send(buffer[i], Rs);
+	}
+#endif
+	return size;
+}
+
 
 /************ low level data pushing commands **********/
 
 // write either command or data
 void LiquidCrystal_I2C::send(uint8_t value, uint8_t mode) {
+#if LCD_I2C_BURST
+	burstBegin();
+	burstSend(value, mode);
+	burstEnd();
+#else
 	uint8_t highnib=value&0xf0;
 	uint8_t lownib=(value<<4)&0xf0;
 	write4bits((highnib)|mode);
 	write4bits((lownib)|mode);
+#endif
 }
 
 void LiquidCrystal_I2C::write4bits(uint8_t value) {
@@ -238,6 +278,36 @@ void LiquidCrystal_I2C::pulseEnable(uint8_t _data){
 	delayMicroseconds(50);		// commands need > 37us to settle
 }
 
+#if LCD_I2C_BURST
+void LiquidCrystal_I2C::burstBegin() {
+	Wire.beginTransmission(_addr);
+	_burstLength = 0;
+}
+
+// queue one command or data byte, starting a new transaction when the
+// Wire buffer cannot take all six expander writes
+void LiquidCrystal_I2C::burstSend(uint8_t value, uint8_t mode) {
+	if (_burstLength + LCD_BURST_PER_SEND > LCD_BURST_BUFFER) {
+		burstEnd();
+		burstBegin();
+	}
+	burstNibble((value&0xf0)|mode);
+	burstNibble(((value<<4)&0xf0)|mode);
+}
+
+void LiquidCrystal_I2C::burstNibble(uint8_t nibble) {
+	uint8_t data = nibble | _backlightval;
+	Wire.write(data);			// set up RS and data lines
+	Wire.write(data | En);		// En high for one I2C byte time
+	Wire.write(data & ~En);		// En low latches the nibble
+	_burstLength += 3;
+}
+
+void LiquidCrystal_I2C::burstEnd() {
+	Wire.endTransmission();
+}
+#endif
+
 void LiquidCrystal_I2C::load_custom_character(uint8_t char_num, uint8_t *rows){
 	createChar(char_num, rows);
 }
@@ -46,6 +46,14 @@
 #define LCD_BACKLIGHT 0x08
 #define LCD_NOBACKLIGHT 0x00
 
+// Send whole characters and strings as one I2C transaction. Each nibble is
+// written as data, data with En high and data with En low back to back; the
+// time one byte takes on the bus (90us at 100kHz, 22.5us at 400kHz) is
+// used as the enable pulse width and the command settle time.
+#ifndef LCD_I2C_BURST
+#define LCD_I2C_BURST 1
+#endif
+
 #define En B00000100  // Enable bit
 #define Rw B00000010  // Read/Write bit
 #define Rs B00000001  // Register select bit
@@ -135,6 +143,8 @@ public:
 	void createChar(uint8_t, uint8_t[]);
 	void setCursor(uint8_t, uint8_t);
 	virtual size_t write(uint8_t);
+	virtual size_t write(const uint8_t *buffer, size_t size);
+	using Print::write;
 	void command(uint8_t);
 
 	inline void blink_on() { blink(); }
@@ -152,6 +162,13 @@ private:
 	void write4bits(uint8_t);
 	void expanderWrite(uint8_t);
 	void pulseEnable(uint8_t);
+#if LCD_I2C_BURST
+	void burstBegin();
+	void burstSend(uint8_t, uint8_t);
+	void burstNibble(uint8_t);
+	void burstEnd();
+	uint8_t _burstLength;
+#endif
 	uint8_t _addr;
 	uint8_t _displayfunction;
 	uint8_t _displaycontrol;
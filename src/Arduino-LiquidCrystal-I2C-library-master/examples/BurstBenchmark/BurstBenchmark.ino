@@ -0,0 +1,35 @@
+#include <Wire.h>
+#include <LiquidCrystal_I2C.h>
+
+// Measures how many characters per second reach the display.
+// Build once as is and once with -DLCD_I2C_BURST=0 to compare the burst
+// transfer with one I2C transaction per expander write.
+
+LiquidCrystal_I2C lcd(0x27, 16, 2);
+
+const char line[] = "0123456789ABCDEF";
+const int rounds = 50;
+
+void setup()
+{
+	Serial.begin(115200);
+	lcd.begin();
+}
+
+void loop()
+{
+	unsigned long start = micros();
+	for (int i = 0; i < rounds; i++) {
+		lcd.setCursor(0, i & 1);
+		lcd.print(line);
+	}
+	unsigned long elapsed = micros() - start;
+
+	Serial.print(LCD_I2C_BURST ? "burst: " : "single: ");
+	Serial.print((unsigned long) rounds * 16 * 1000000UL / elapsed);
+	Serial.print(" chars/s, ");
+	Serial.print(elapsed / ((unsigned long) rounds * 16));
+	Serial.println(" us/char");
+
+	delay(2000);
+}
@@ -5,12 +5,11 @@
 #include "Button.h"
 
 
-unsigned long Button::lastTimeClicked = 0;
 const uint8_t Button::buttonDelay = 20;
 
 
-Button::Button(byte pin, bool idleState)
-: pin(pin), idleState(idleState) {
+Button::Button(byte pin, bool idleState, byte integratorSamples)
+: pin(pin), idleState(idleState), integratorMax(integratorSamples) {
     pinMode(pin, INPUT);
 }
 
@@ -18,6 +17,9 @@ Button::Button(byte pin, bool idleState)
 bool Button::beenClicked() {
     /* Implementation of checking if button has been clicked
        Reduces debouncing effect */
+    if (integratorMax)
+        return integrate();
+
     currentState = digitalRead(pin);
 
     if (currentState != lastButtonState)
@@ -38,6 +40,25 @@ bool Button::beenClicked() {
     return false;
 }
 
+bool Button::integrate() {
+    /* Counts towards integratorMax while the input is active and back to 0
+       while it is idle, the state only flips at either end of the range */
+    bool active = digitalRead(pin) != idleState;
+
+    if (active && integrator < integratorMax)
+        integrator++;
+    else if (!active && integrator > 0)
+        integrator--;
+
+    if (integrator == 0) {
+        buttonState = idleState;
+    } else if (integrator == integratorMax && buttonState == idleState) {
+        buttonState = !idleState;
+        return true;
+    }
+    return false;
+}
+
 bool Button::isPressed() const {
     return digitalRead(pin) != idleState;
 }
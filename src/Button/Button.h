@@ -10,19 +10,28 @@
 
 class Button {
 public:
-    Button(byte pin, bool idleState);
+    /* integratorSamples = 0 debounces on time (buttonDelay ms of a stable
+       level). Otherwise a counter goes up on every beenClicked() call that
+       sees the input active and down on every idle one, without reading
+       the clock: a press is reported when it reaches integratorSamples,
+       the release when it is back at 0. */
+    Button(byte pin, bool idleState, byte integratorSamples = 0);
     bool beenClicked();
     bool isPressed() const;
 
 private:
-    static unsigned long lastTimeClicked;
     static const byte buttonDelay;
 
     const byte pin;
     const bool idleState;
+    const byte integratorMax;
+    unsigned long lastTimeClicked = 0;
+    byte integrator = 0;
     bool buttonState = idleState;
     bool lastButtonState = idleState;
     bool currentState = idleState;
+
+    bool integrate();
 };
 
 #endif
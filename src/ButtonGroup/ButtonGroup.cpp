@@ -0,0 +1,77 @@
+//
+// Created by rafal on 17.10.2026.
+//
+
+#include "ButtonGroup.h"
+
+
+ButtonGroup::ButtonGroup(byte pinMask, byte activeHighMask)
+: pinMask(pinMask), activeHighMask(activeHighMask & pinMask) {
+}
+
+
+void ButtonGroup::begin() {
+    for (byte pin = 0; pin < 8; pin++) {
+        if (bitRead(pinMask, pin))
+            pinMode(pin, INPUT);
+    }
+
+    // Start from the current levels instead of reporting them as presses
+    levels = readActive();
+    debounced = levels;
+}
+
+
+byte ButtonGroup::readActive() const {
+    byte port;
+#if defined(__AVR_ATmega328P__) || defined(__AVR_ATmega328__) || defined(__AVR_ATmega168__)
+    port = PIND;
+#else
+    port = 0;
+    for (byte pin = 0; pin < 8; pin++) {
+        if (bitRead(pinMask, pin) && digitalRead(pin))
+            bitSet(port, pin);
+    }
+#endif
+    // Flip the active low inputs so that 1 always means active
+    return (port ^ ~activeHighMask) & pinMask;
+}
+
+
+bool ButtonGroup::update() {
+    /* Samples the inputs for one tick, returns true if any debounced
+       state changed */
+    levels = readActive();
+
+    // Count the ticks each input differs from its debounced state, the
+    // counters of inputs that agree are reset to their start value
+    byte toggle = levels ^ debounced;
+    counter0 = ~(counter0 & toggle);
+    counter1 = counter0 ^ (counter1 & toggle);
+    toggle &= counter0 & counter1;
+
+    debounced ^= toggle;
+    risingEdges = toggle & debounced;
+    fallingEdges = toggle & ~debounced;
+    return toggle;
+}
+
+
+byte ButtonGroup::state() const {
+    return debounced;
+}
+
+
+byte ButtonGroup::pressed() const {
+    return risingEdges;
+}
+
+
+byte ButtonGroup::released() const {
+    return fallingEdges;
+}
+
+
+byte ButtonGroup::raw() const {
+    return levels;
+}
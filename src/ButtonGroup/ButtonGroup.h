@@ -0,0 +1,47 @@
+//
+// Created by rafal on 17.10.2026.
+//
+
+#ifndef ARDUINO_CAMPER_CONTROLLER_BUTTONGROUP_H
+#define ARDUINO_CAMPER_CONTROLLER_BUTTONGROUP_H
+
+#include <Arduino.h>
+
+
+/* Up to eight inputs on digital pins 0-7, which is PORTD on the Uno.
+   update() samples all of them with a single PIND read and debounces them
+   in parallel with 2-bit vertical counters: an input changes state after
+   four ticks at the same level. Each update() is one tick, the caller runs
+   it at a fixed period. Masks use bit n for pin n. */
+class ButtonGroup {
+public:
+    static const byte debounceSamples = 4;
+
+    ButtonGroup(byte pinMask, byte activeHighMask);
+
+    void begin();
+    bool update();
+
+    // Debounced inputs that are active
+    byte state() const;
+    // Became active / idle on the last tick
+    byte pressed() const;
+    byte released() const;
+    // Undebounced levels from the last update(), active = 1
+    byte raw() const;
+
+private:
+    const byte pinMask;
+    const byte activeHighMask;
+
+    byte levels = 0;
+    byte debounced = 0;
+    byte counter0 = 0xFF;
+    byte counter1 = 0xFF;
+    byte risingEdges = 0;
+    byte fallingEdges = 0;
+
+    byte readActive() const;
+};
+
+#endif
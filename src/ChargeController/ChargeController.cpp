@@ -0,0 +1,85 @@
+//
+// Created by rafal on 17.10.2026.
+//
+
+#include "ChargeController.h"
+
+
+ChargeController::ChargeController(byte relayPin, const Config &config)
+: relayPin(relayPin), config(config) {
+}
+
+
+void ChargeController::begin(unsigned long time) {
+    pinMode(relayPin, OUTPUT);
+    digitalWrite(relayPin, LOW);
+    state = IDLE;
+    stateTime = time;
+    filterPrimed = false;
+}
+
+
+bool ChargeController::update(uint16_t voltage, unsigned long time) {
+    /* One tick per call, returns true on the ticks that change the state */
+    if (!filterPrimed) {
+        filter = (unsigned long) voltage << filterShift;
+        filterPrimed = true;
+    } else {
+        filter = filter - (filter >> filterShift) + voltage;
+    }
+
+    uint16_t filtered = filteredVoltage();
+    unsigned long inState = time - stateTime;
+    State previous = state;
+
+    switch (state) {
+        case IDLE:
+            if (filtered >= config.cutIn)
+                enter(PENDING, time);
+            break;
+
+        case PENDING:
+            if (filtered < config.cutIn)
+                enter(IDLE, time);
+            else if (inState >= config.chargeDelay)
+                enter(CHARGING, time);
+            break;
+
+        case CHARGING:
+            if (filtered < config.cutOut && inState >= config.minOnTime)
+                enter(COOLDOWN, time);
+            break;
+
+        case COOLDOWN:
+            if (inState >= config.minOffTime)
+                enter(IDLE, time);
+            break;
+    }
+    return state != previous;
+}
+
+
+void ChargeController::enter(State next, unsigned long time) {
+    if (next == CHARGING)
+        digitalWrite(relayPin, HIGH);
+    else if (state == CHARGING)
+        digitalWrite(relayPin, LOW);
+
+    state = next;
+    stateTime = time;
+}
+
+
+ChargeController::State ChargeController::getState() const {
+    return state;
+}
+
+
+bool ChargeController::isCharging() const {
+    return state == CHARGING;
+}
+
+
+uint16_t ChargeController::filteredVoltage() const {
+    return filter >> filterShift;
+}
@@ -0,0 +1,64 @@
+//
+// Created by rafal on 17.10.2026.
+//
+
+#ifndef ARDUINO_CAMPER_CONTROLLER_CHARGECONTROLLER_H
+#define ARDUINO_CAMPER_CONTROLLER_CHARGECONTROLLER_H
+
+#include <Arduino.h>
+
+
+/* Split-charge relay between the starter battery and the second battery.
+   Each update() is one tick on a low-pass filtered starter battery voltage,
+   the caller runs it every tickTime:
+
+   IDLE      relay open, waits for the voltage to reach cutIn
+   PENDING   still at cutIn after chargeDelay closes the relay
+   CHARGING  relay closed for at least minOnTime, opens below cutOut
+   COOLDOWN  relay open for at least minOffTime, then back to IDLE
+
+   cutOut sits below cutIn since the starter battery sags once the second
+   battery is connected. */
+class ChargeController {
+public:
+    enum State {
+        IDLE,
+        PENDING,
+        CHARGING,
+        COOLDOWN
+    };
+
+    struct Config {
+        uint16_t cutIn;             // mV
+        uint16_t cutOut;            // mV
+        unsigned long chargeDelay;  // ms
+        unsigned long minOnTime;    // ms
+        unsigned long minOffTime;   // ms
+        unsigned int tickTime;      // ms
+    };
+
+    ChargeController(byte relayPin, const Config &config);
+
+    void begin(unsigned long time);
+    bool update(uint16_t voltage, unsigned long time);
+
+    State getState() const;
+    bool isCharging() const;
+    uint16_t filteredVoltage() const;
+
+private:
+    // Each tick moves the filter 1/8 of the way to the new sample
+    static const byte filterShift = 3;
+
+    const byte relayPin;
+    const Config config;
+
+    State state = IDLE;
+    unsigned long stateTime = 0;
+    unsigned long filter = 0;       // mV << filterShift
+    bool filterPrimed = false;
+
+    void enter(State next, unsigned long time);
+};
+
+#endif
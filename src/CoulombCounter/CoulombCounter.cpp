@@ -0,0 +1,156 @@
+//
+// Created by rafal on 17.10.2026.
+//
+
+#include "CoulombCounter.h"
+
+#include <EEPROM.h>
+#include <math.h>
+
+
+CoulombCounter::CoulombCounter(unsigned long capacityMah, byte ratedHours, byte peukert,
+                               byte chargeEfficiency, int eepromAddress)
+: capacity(capacityMah * 3600), ratedCurrent(capacityMah / ratedHours), peukert(peukert),
+  chargeEfficiency(chargeEfficiency), eepromAddress(eepromAddress) {
+}
+
+
+void CoulombCounter::begin(unsigned long time) {
+    /* The only floating point, once at start: Peukert factors for currents
+       of 1, 2, 4 ... 32768 mA, update() interpolates between them */
+    double exponent = (peukert - 100) / 100.0;
+    for (byte n = 0; n < 16; n++) {
+        double factor = pow((double) (1UL << n) / ratedCurrent, exponent) * (1 << peukertBits);
+        peukertFactors[n] = factor > 0xFFFF ? 0xFFFF : (uint16_t) factor;
+    }
+
+    if (!load())
+        charge = capacity;
+    savedCharge = charge;
+    remainder = 0;
+    lastUpdate = time;
+}
+
+
+void CoulombCounter::update(uint16_t current, bool charging, unsigned long time) {
+    unsigned long elapsed = time - lastUpdate;
+    lastUpdate = time;
+
+    long flow = charging ? (long) current * chargeEfficiency / 100 : -(long) effectiveCurrent(current);
+    while (elapsed > maxStep) {
+        integrate(flow, maxStep);
+        elapsed -= maxStep;
+    }
+    integrate(flow, elapsed);
+
+    /* Full and empty are saved as well, they are where the estimate is
+       most likely to be checked */
+    bool limit = charge == capacity || charge == 0;
+    if (labs(charge - savedCharge) >= capacity / 100 || (limit && charge != savedCharge))
+        save();
+}
+
+
+uint16_t CoulombCounter::effectiveCurrent(uint16_t current) const {
+    /* Linear between the factors of the powers of two around current */
+    if (current == 0)
+        return 0;
+
+    byte n = 15;
+    while (!(current & (1U << n)))
+        n--;
+    uint16_t low = peukertFactors[n];
+    uint16_t high = n < 15 ? peukertFactors[n + 1] : low;
+    uint16_t fraction = ((unsigned long) (current - (1U << n)) << 8) >> n;
+    long factor = low + (((long) high - low) * fraction >> 8);
+
+    unsigned long effective = ((unsigned long) current * factor) >> peukertBits;
+    return effective > 0xFFFF ? 0xFFFF : effective;
+}
+
+
+void CoulombCounter::integrate(long current, uint16_t duration) {
+    remainder += current * duration;
+    charge += remainder / 1000;
+    remainder %= 1000;
+
+    if (charge >= capacity) {
+        charge = capacity;
+        remainder = 0;
+    } else if (charge < 0) {
+        charge = 0;
+        remainder = 0;
+    }
+}
+
+
+byte CoulombCounter::percent() const {
+    return (charge + capacity / 200) / (capacity / 100);
+}
+
+
+unsigned long CoulombCounter::remainingMah() const {
+    return charge / 3600;
+}
+
+
+bool CoulombCounter::readSlot(byte index, byte &slotSequence, long &slotCharge) const {
+    /* sequence, charge LSB first, check = sum of the five + 0x5A, which an
+       erased slot (all 0xFF) never passes */
+    int address = eepromAddress + index * slotSize;
+    byte bytes[slotSize];
+    byte sum = 0x5A;
+    for (byte i = 0; i < slotSize; i++) {
+        bytes[i] = EEPROM.read(address + i);
+        if (i < slotSize - 1)
+            sum += bytes[i];
+    }
+    if (sum != bytes[slotSize - 1])
+        return false;
+
+    slotSequence = bytes[0];
+    slotCharge = (long) bytes[1] | (long) bytes[2] << 8 | (long) bytes[3] << 16 | (long) bytes[4] << 24;
+    return true;
+}
+
+
+bool CoulombCounter::load() {
+    /* Saves go to consecutive slots with consecutive sequence numbers, the
+       latest is the valid slot not followed by its successor */
+    for (byte i = 0; i < slotCount; i++) {
+        byte slotSequence, nextSequence;
+        long slotCharge, nextCharge;
+        if (!readSlot(i, slotSequence, slotCharge))
+            continue;
+
+        byte next = (i + 1) % slotCount;
+        if (readSlot(next, nextSequence, nextCharge) && nextSequence == (byte) (slotSequence + 1))
+            continue;
+
+        charge = constrain(slotCharge, 0, capacity);
+        sequence = slotSequence + 1;
+        slot = next;
+        return true;
+    }
+    return false;
+}
+
+
+void CoulombCounter::save() {
+    /* About 3.4 ms per byte that changes. The check byte goes last, so a
+       reset half way leaves the slot invalid and the previous one wins. */
+    int address = eepromAddress + slot * slotSize;
+    byte bytes[slotSize] = {
+            sequence,
+            (byte) charge, (byte) (charge >> 8), (byte) (charge >> 16), (byte) (charge >> 24),
+            0x5A
+    };
+    for (byte i = 0; i < slotSize - 1; i++)
+        bytes[slotSize - 1] += bytes[i];
+    for (byte i = 0; i < slotSize; i++)
+        EEPROM.update(address + i, bytes[i]);
+
+    savedCharge = charge;
+    sequence++;
+    slot = (slot + 1) % slotCount;
+}
@@ -0,0 +1,64 @@
+//
+// Created by rafal on 17.10.2026.
+//
+
+#ifndef ARDUINO_CAMPER_CONTROLLER_COULOMBCOUNTER_H
+#define ARDUINO_CAMPER_CONTROLLER_COULOMBCOUNTER_H
+
+#include <Arduino.h>
+
+
+/* State of charge of a battery from its current integrated over time.
+   Charge is kept in mA*s with the sub-second remainder in mA*ms, so update()
+   is integer only. Discharge is weighted by Peukert's law against the
+   rated (capacity / ratedHours) current, charge by the charge efficiency.
+
+   The charge is saved to EEPROM when it moves by 1% of capacity or hits
+   full or empty. Each save goes to the next of a ring of slots tagged with
+   a sequence number, so the cells wear evenly, and begin() picks up the
+   latest valid slot. */
+class CoulombCounter {
+public:
+    static const byte slotCount = 32;
+    static const byte slotSize = 6;
+
+    // peukert is the exponent * 100, e.g. 125 for 1.25
+    CoulombCounter(unsigned long capacityMah, byte ratedHours, byte peukert,
+                   byte chargeEfficiency, int eepromAddress);
+
+    void begin(unsigned long time);
+    void update(uint16_t current, bool charging, unsigned long time);
+
+    byte percent() const;
+    unsigned long remainingMah() const;
+
+private:
+    static const byte peukertBits = 12;
+    static const uint16_t maxStep = 10000;   // ms integrated at once
+
+    const long capacity;                     // mA*s
+    const unsigned long ratedCurrent;        // mA
+    const byte peukert;
+    const byte chargeEfficiency;
+    const int eepromAddress;
+
+    // (2^n mA / rated current)^(peukert - 1) in 1/4096 steps
+    uint16_t peukertFactors[16];
+
+    long charge = 0;                         // mA*s
+    long remainder = 0;                      // mA*ms, below one mA*s
+    unsigned long lastUpdate = 0;
+
+    long savedCharge = 0;
+    byte sequence = 0;
+    byte slot = 0;
+
+    uint16_t effectiveCurrent(uint16_t current) const;
+    void integrate(long current, uint16_t duration);
+
+    bool load();
+    void save();
+    bool readSlot(byte index, byte &slotSequence, long &slotCharge) const;
+};
+
+#endif
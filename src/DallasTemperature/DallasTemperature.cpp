@@ -77,17 +77,43 @@ void DallasTemperature::setOneWire(OneWire* _oneWire) {
 	bitResolution = 9;
 	waitForConversion = true;
 	checkForConversion = true;
+	cachedDevices = 0;
+	hotPlugDetection = false;
+	autoSaveScratchPad = true;
 
 }
 
+OneWire* DallasTemperature::getOneWire() {
+	return _wire;
+}
+
 // initialise the bus
 void DallasTemperature::begin(void) {
 
+	enumerate();
+
+}
+
+// re-enumerate the bus, e.g. after a sensor has been plugged in or removed
+// returns true if the cached address table changed
+bool DallasTemperature::rescan(void) {
+
+	return enumerate();
+
+}
+
+// walk the whole ROM tree once and remember every valid address, so the
+// *ByIndex functions do not have to search the bus on each call
+bool DallasTemperature::enumerate(void) {
+
 	DeviceAddress deviceAddress;
+	uint8_t previousCount = cachedDevices;
+	bool changed = false;
 
 	_wire->reset_search();
 	devices = 0; // Reset the number of devices when we enumerate wire devices
 	ds18Count = 0; // Reset number of DS18xxx Family devices
+	parasite = false;
 
 	while (_wire->search(deviceAddress)) {
 
@@ -98,6 +124,16 @@ void DallasTemperature::begin(void) {
 
 			bitResolution = max(bitResolution, getResolution(deviceAddress));
 
+			if (devices < MAXCACHEDDEVICES) {
+				if (devices >= previousCount
+						|| memcmp(addressCache[devices], deviceAddress,
+								sizeof(DeviceAddress)) != 0) {
+					changed = true;
+				}
+				memcpy(addressCache[devices], deviceAddress,
+						sizeof(DeviceAddress));
+			}
+
 			devices++;
 			if (validFamily(deviceAddress)) {
 				ds18Count++;
@@ -105,6 +141,12 @@ void DallasTemperature::begin(void) {
 		}
 	}
 
+	cachedDevices = min(devices, (uint8_t) MAXCACHEDDEVICES);
+	if (cachedDevices != previousCount)
+		changed = true;
+
+	return changed;
+
 }
 
 // returns the number of devices found on the bus
@@ -125,14 +167,25 @@ bool DallasTemperature::validAddress(const uint8_t* deviceAddress) {
 // returns true if the device was found
 bool DallasTemperature::getAddress(uint8_t* deviceAddress, uint8_t index) {
 
+	if (index < cachedDevices) {
+		memcpy(deviceAddress, addressCache[index], sizeof(DeviceAddress));
+		return true;
+	}
+
+	// the cache holds everything begin() found unless it was full
+	if (cachedDevices < MAXCACHEDDEVICES)
+		return false;
+
 	uint8_t depth = 0;
 
 	_wire->reset_search();
 
 	while (depth <= index && _wire->search(deviceAddress)) {
-		if (depth == index && validAddress(deviceAddress))
-			return true;
-		depth++;
+		if (validAddress(deviceAddress)) {
+			if (depth == index)
+				return true;
+			depth++;
+		}
 	}
 
 	return false;
@@ -202,6 +255,9 @@ void DallasTemperature::writeScratchPad(const uint8_t* deviceAddress,
 
 	_wire->reset();
 
+	if (!autoSaveScratchPad)
+		return;
+
 	// save the newly written values to eeprom
 	_wire->select(deviceAddress);
 	_wire->write(COPYSCRATCH, parasite);
@@ -230,11 +286,15 @@ bool DallasTemperature::readPowerSupply(const uint8_t* deviceAddress) {
 // if new resolution is out of range, it is constrained.
 void DallasTemperature::setResolution(uint8_t newResolution) {
 
-	bitResolution = constrain(newResolution, 9, 12);
+	newResolution = constrain(newResolution, 9, 12);
+	bitResolution = newResolution;
 	DeviceAddress deviceAddress;
 	for (int i = 0; i < devices; i++) {
 		getAddress(deviceAddress, i);
-		setResolution(deviceAddress, bitResolution, true);
+		setResolution(deviceAddress, newResolution, true);
+		// DS18S20 conversions always take the 12 bit time
+		if (deviceAddress[0] == DS18S20MODEL)
+			bitResolution = 12;
 	}
 
 }
@@ -247,31 +307,35 @@ bool DallasTemperature::setResolution(const uint8_t* deviceAddress,
 	// ensure same behavior as setResolution(uint8_t newResolution)
 	newResolution = constrain(newResolution, 9, 12);
 
-	// return when stored value == new value
-	if (getResolution(deviceAddress) == newResolution)
-		return true;
-
 	ScratchPad scratchPad;
 	if (isConnected(deviceAddress, scratchPad)) {
 
 		// DS1820 and DS18S20 have no resolution configuration register
 		if (deviceAddress[0] != DS18S20MODEL) {
 
+			uint8_t configuration;
 			switch (newResolution) {
 			case 12:
-				scratchPad[CONFIGURATION] = TEMP_12_BIT;
+				configuration = TEMP_12_BIT;
 				break;
 			case 11:
-				scratchPad[CONFIGURATION] = TEMP_11_BIT;
+				configuration = TEMP_11_BIT;
 				break;
 			case 10:
-				scratchPad[CONFIGURATION] = TEMP_10_BIT;
+				configuration = TEMP_10_BIT;
 				break;
 			case 9:
 			default:
-				scratchPad[CONFIGURATION] = TEMP_9_BIT;
+				configuration = TEMP_9_BIT;
 				break;
 			}
+
+			// return when stored value == new value, the scratchpad
+			// read above already has it
+			if (scratchPad[CONFIGURATION] == configuration)
+				return true;
+
+			scratchPad[CONFIGURATION] = configuration;
 			writeScratchPad(deviceAddress, scratchPad);
 
 			// without calculation we can always set it to max
@@ -354,6 +418,32 @@ bool DallasTemperature::getCheckForConversion() {
 	return checkForConversion;
 }
 
+// sets the value of the hotPlugDetection flag
+// TRUE : a *ByIndex function that cannot reach its device rescans the bus once
+//        and retries, so sensors plugged in or swapped after begin() are found
+// FALSE: the address table only changes when begin() or rescan() is called
+void DallasTemperature::setHotPlugDetection(bool flag) {
+	hotPlugDetection = flag;
+}
+
+// gets the value of the hotPlugDetection flag
+bool DallasTemperature::getHotPlugDetection() {
+	return hotPlugDetection;
+}
+
+// sets the value of the autoSaveScratchPad flag
+// TRUE : writeScratchPad() and the functions built on it copy the new values
+//        to the EEPROM, so they survive a power cycle (20ms, and EEPROM wear)
+// FALSE: only the scratchpad changes, for settings that change often
+void DallasTemperature::setAutoSaveScratchPad(bool flag) {
+	autoSaveScratchPad = flag;
+}
+
+// gets the value of the autoSaveScratchPad flag
+bool DallasTemperature::getAutoSaveScratchPad() {
+	return autoSaveScratchPad;
+}
+
 bool DallasTemperature::isConversionComplete() {
 	uint8_t b = _wire->read_bit();
 	return (b == 1);
@@ -404,7 +494,7 @@ void DallasTemperature::blockTillConversionComplete(uint8_t bitResolution) {
 	int delms = millisToWaitForConversion(bitResolution);
 	if (checkForConversion && !parasite) {
 		unsigned long now = millis();
-		while (!isConversionComplete() && (millis() - delms < now))
+		while (!isConversionComplete() && (millis() - now < (unsigned long) delms))
 			;
 	} else {
 		delay(delms);
@@ -438,34 +528,37 @@ bool DallasTemperature::requestTemperaturesByIndex(uint8_t deviceIndex) {
 
 }
 
-// Fetch temperature for device index
-float DallasTemperature::getTempCByIndex(uint8_t deviceIndex) {
+// Fetch raw temperature for device index
+int16_t DallasTemperature::getTempByIndex(uint8_t deviceIndex) {
 
 	DeviceAddress deviceAddress;
-	if (!getAddress(deviceAddress, deviceIndex)) {
-		return DEVICE_DISCONNECTED_C;
-	}
-
-	return getTempC((uint8_t*) deviceAddress);
+	int16_t raw = DEVICE_DISCONNECTED_RAW;
 
-}
+	if (getAddress(deviceAddress, deviceIndex))
+		raw = getTemp(deviceAddress);
 
-// Fetch temperature for device index
-float DallasTemperature::getTempFByIndex(uint8_t deviceIndex) {
+	// the device may have been unplugged or replaced, look at the bus again
+	if (raw == DEVICE_DISCONNECTED_RAW && hotPlugDetection && rescan()
+			&& getAddress(deviceAddress, deviceIndex))
+		raw = getTemp(deviceAddress);
 
-	DeviceAddress deviceAddress;
+	return raw;
 
-	if (!getAddress(deviceAddress, deviceIndex)) {
-		return DEVICE_DISCONNECTED_F;
-	}
+}
 
-	return getTempF((uint8_t*) deviceAddress);
+// Fetch temperature for device index
+float DallasTemperature::getTempCByIndex(uint8_t deviceIndex) {
+	return rawToCelsius(getTempByIndex(deviceIndex));
+}
 
+// Fetch temperature for device index
+float DallasTemperature::getTempFByIndex(uint8_t deviceIndex) {
+	return rawToFahrenheit(getTempByIndex(deviceIndex));
 }
 
 // reads scratchpad and returns fixed-point temperature, scaling factor 2^-7
 int16_t DallasTemperature::calculateTemperature(const uint8_t* deviceAddress,
-		uint8_t* scratchPad) {
+		const uint8_t* scratchPad) {
 
 	int16_t fpTemperature = (((int16_t) scratchPad[TEMP_MSB]) << 11)
 			| (((int16_t) scratchPad[TEMP_LSB]) << 3);
@@ -496,7 +589,7 @@ int16_t DallasTemperature::calculateTemperature(const uint8_t* deviceAddress,
 	 */
 
 	if (deviceAddress[0] == DS18S20MODEL) {
-		fpTemperature = ((fpTemperature & 0xfff0) << 3) - 16
+		fpTemperature = ((fpTemperature & 0xfff0) << 3) - 32
 				+ (((scratchPad[COUNT_PER_C] - scratchPad[COUNT_REMAIN]) << 7)
 						/ scratchPad[COUNT_PER_C]);
 	}
@@ -518,6 +611,39 @@ int16_t DallasTemperature::getTemp(const uint8_t* deviceAddress) {
 
 }
 
+// returns temperature in 1/128 degrees C or DEVICE_DISCONNECTED_RAW, and
+// the resolution in the CONFIGURATION byte of the same scratchpad, which
+// a device that lost power has reloaded from its EEPROM
+int16_t DallasTemperature::getTemp(const uint8_t* deviceAddress,
+		uint8_t* resolution) {
+
+	ScratchPad scratchPad;
+	if (!readScratchPad(deviceAddress, scratchPad)) {
+		*resolution = 0;
+		return DEVICE_DISCONNECTED_RAW;
+	}
+	return decodeScratchPad(deviceAddress, scratchPad, resolution);
+
+}
+
+// the same from a scratchpad read elsewhere, checked against its CRC
+int16_t DallasTemperature::decodeScratchPad(const uint8_t* deviceAddress,
+		const uint8_t* scratchPad, uint8_t* resolution) {
+
+	*resolution = 0;
+	if (OneWire::crc8(scratchPad, 8) != scratchPad[SCRATCHPAD_CRC])
+		return DEVICE_DISCONNECTED_RAW;
+
+	// DS1820 and DS18S20 have no resolution configuration register,
+	// bits 5 and 6 of the others are TEMP_9_BIT to TEMP_12_BIT
+	if (deviceAddress[0] == DS18S20MODEL)
+		*resolution = 12;
+	else
+		*resolution = 9 + ((scratchPad[CONFIGURATION] >> 5) & 0x03);
+	return calculateTemperature(deviceAddress, scratchPad);
+
+}
+
 // returns temperature in degrees C or DEVICE_DISCONNECTED_C if the
 // device's scratch pad cannot be read successfully.
 // the numeric value of DEVICE_DISCONNECTED_C is defined in
@@ -18,9 +18,20 @@
 #define REQUIRESALARMS true
 #endif
 
+// number of device addresses cached by begin() for the *ByIndex functions,
+// devices past this index are still looked up by searching the bus
+#ifndef MAXCACHEDDEVICES
+#define MAXCACHEDDEVICES 8
+#endif
+
 #include <inttypes.h>
 #include "OneWire/OneWire.h"
 
+// The 1-Wire transport is picked at compile time, see OneWire.h: the pin,
+// bit-banged or timed from Timer1, or USART0 with ONEWIRE_UART=1. The
+// UART cannot drive the bus high, parasite powered sensors then need an
+// external strong pull-up during conversions.
+
 // Model IDs
 #define DS18S20MODEL 0x10  // also DS1820
 #define DS18B20MODEL 0x28
@@ -43,9 +54,20 @@ public:
 
 	void setOneWire(OneWire*);
 
+	// the bus given above, e.g. to queue transactions on its transport
+	OneWire* getOneWire(void);
+
 	// initialise bus
 	void begin(void);
 
+	// re-enumerates the bus and refreshes the cached address table,
+	// returns true if the set of devices changed
+	bool rescan(void);
+
+	// sets/gets the hot-plug detection flag
+	void setHotPlugDetection(bool);
+	bool getHotPlugDetection(void);
+
 	// returns the number of devices found on the bus
 	uint8_t getDeviceCount(void);
 
@@ -98,6 +120,10 @@ public:
 	void setCheckForConversion(bool);
 	bool getCheckForConversion(void);
 
+	// sets/gets the autoSaveScratchPad flag
+	void setAutoSaveScratchPad(bool);
+	bool getAutoSaveScratchPad(void);
+
 	// sends command for all devices on the bus to perform a temperature conversion
 	void requestTemperatures(void);
 
@@ -110,6 +136,15 @@ public:
 	// returns temperature raw value (12 bit integer of 1/128 degrees C)
 	int16_t getTemp(const uint8_t*);
 
+	// as above, also returns the resolution the reading was converted at
+	// from the same scratchpad read, 0 if it could not be read
+	int16_t getTemp(const uint8_t*, uint8_t*);
+
+	// as above from a scratchpad the caller read itself, e.g. with a
+	// queued OneWireTransaction: DEVICE_DISCONNECTED_RAW and resolution 0
+	// if its CRC does not match
+	static int16_t decodeScratchPad(const uint8_t*, const uint8_t*, uint8_t*);
+
 	// returns temperature in degrees C
 	float getTempC(const uint8_t*);
 
@@ -227,14 +262,30 @@ private:
 	// count of DS18xxx Family devices on bus
 	uint8_t ds18Count;
 
+	// addresses found by the last bus enumeration
+	DeviceAddress addressCache[MAXCACHEDDEVICES];
+	uint8_t cachedDevices;
+
+	// used to rescan the bus when a *ByIndex lookup fails
+	bool hotPlugDetection;
+
+	// used by writeScratchPad to copy the new values to the EEPROM
+	bool autoSaveScratchPad;
+
 	// Take a pointer to one wire instance
 	OneWire* _wire;
 
 	// reads scratchpad and returns the raw temperature
-	int16_t calculateTemperature(const uint8_t*, uint8_t*);
+	static int16_t calculateTemperature(const uint8_t*, const uint8_t*);
 
 	void blockTillConversionComplete(uint8_t);
 
+	// walks the bus and fills the address cache, returns true if it changed
+	bool enumerate(void);
+
+	// returns raw temperature for device index, rescanning once if enabled
+	int16_t getTempByIndex(uint8_t);
+
 #if REQUIRESALARMS
 
 	// required for alarmSearch
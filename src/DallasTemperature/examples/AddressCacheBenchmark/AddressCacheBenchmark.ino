@@ -0,0 +1,78 @@
+//
+// Compares the cost of getTempCByIndex() with the cached address table
+// against the old behaviour of searching the bus for the address first.
+//
+// Build with -DONEWIRE_SLOT_COUNTER=1 so OneWire counts reset pulses and
+// bit slots, e.g. build_flags = -DONEWIRE_SLOT_COUNTER=1 in platformio.ini
+//
+#include <OneWire.h>
+#include <DallasTemperature.h>
+
+#if !ONEWIRE_SLOT_COUNTER
+#error "AddressCacheBenchmark needs ONEWIRE_SLOT_COUNTER=1"
+#endif
+
+// Data wire is plugged into port 2 on the Arduino
+#define ONE_WIRE_BUS 2
+
+OneWire oneWire(ONE_WIRE_BUS);
+DallasTemperature sensors(&oneWire);
+
+// Address lookup as done before the cache: restart the search and walk
+// the ROM tree up to the requested index.
+bool searchAddress(uint8_t* deviceAddress, uint8_t index)
+{
+  uint8_t depth = 0;
+  oneWire.reset_search();
+  while (depth <= index && oneWire.search(deviceAddress)) {
+    if (depth == index && sensors.validAddress(deviceAddress))
+      return true;
+    depth++;
+  }
+  return false;
+}
+
+void report(const char* label, uint32_t slots, unsigned long us)
+{
+  Serial.print(label);
+  Serial.print(slots);
+  Serial.print(" slots, ");
+  Serial.print(us);
+  Serial.println(" us");
+}
+
+void setup(void)
+{
+  Serial.begin(115200);
+  Serial.println("Dallas Temperature Control Library - Address Cache Benchmark");
+
+  sensors.begin();
+  Serial.print("Devices: ");
+  Serial.println(sensors.getDeviceCount());
+
+  sensors.requestTemperatures();
+}
+
+void loop(void)
+{
+  for (uint8_t i = 0; i < sensors.getDeviceCount(); i++) {
+    DeviceAddress deviceAddress;
+    unsigned long start;
+
+    Serial.print("Index ");
+    Serial.println(i);
+
+    oneWire.clearSlotCount();
+    start = micros();
+    if (searchAddress(deviceAddress, i))
+      sensors.getTempC(deviceAddress);
+    report("  search + read: ", oneWire.getSlotCount(), micros() - start);
+
+    oneWire.clearSlotCount();
+    start = micros();
+    sensors.getTempCByIndex(i);
+    report("  cached read:   ", oneWire.getSlotCount(), micros() - start);
+  }
+  Serial.println();
+  delay(5000);
+}
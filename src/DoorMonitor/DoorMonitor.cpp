@@ -0,0 +1,143 @@
+//
+// Created by rafal on 17.10.2026.
+//
+
+#include "DoorMonitor.h"
+
+
+#if DOOR_MONITOR_PCINT
+static DoorMonitor *pinChangeMonitor = nullptr;
+
+ISR(PCINT2_vect) {
+    if (pinChangeMonitor != nullptr)
+        pinChangeMonitor->pinChange();
+}
+#endif
+
+
+DoorMonitor::DoorMonitor(byte pinMask)
+: pinMask(pinMask) {
+}
+
+
+void DoorMonitor::begin() {
+    for (byte pin = 0; pin < 8; pin++) {
+        if (bitRead(pinMask, pin))
+            pinMode(pin, INPUT);
+    }
+    levels = readPins();
+    clear();
+
+#if DOOR_MONITOR_PCINT
+    pinChangeMonitor = this;
+    PCMSK2 |= pinMask;
+    PCIFR = _BV(PCIF2);
+    PCICR |= _BV(PCIE2);
+#endif
+}
+
+
+void DoorMonitor::poll() {
+    /* Without the interrupt the edges are picked up here, once per loop() */
+#if !DOOR_MONITOR_PCINT
+    pinChange();
+#endif
+}
+
+
+byte DoorMonitor::readPins() const {
+#if DOOR_MONITOR_PCINT
+    return PIND & pinMask;
+#else
+    byte port = 0;
+    for (byte pin = 0; pin < 8; pin++) {
+        if (bitRead(pinMask, pin) && digitalRead(pin))
+            bitSet(port, pin);
+    }
+    return port;
+#endif
+}
+
+
+void DoorMonitor::pinChange() {
+    /* Interrupt context on the Uno: one PIND read, an event per changed pin */
+    byte now = readPins();
+    byte changed = now ^ levels;
+    levels = now;
+    if (!changed)
+        return;
+
+    unsigned long time = millis();
+    for (byte pin = 0; pin < 8; pin++) {
+        if (!bitRead(changed, pin))
+            continue;
+
+        // One waiting open and one waiting close per pin, levels has the rest
+        bool open = bitRead(now, pin);
+        if (bitRead(open ? queuedOpen : queuedClosed, pin))
+            continue;
+        if (open)
+            bitSet(queuedOpen, pin);
+        else
+            bitSet(queuedClosed, pin);
+
+        byte next = (head + 1) & (eventMax - 1);
+        if (next == tail) {
+            unqueue(tail);
+            tail = (tail + 1) & (eventMax - 1);
+        }
+        events[head].pin = pin;
+        events[head].open = open;
+        events[head].time = time;
+        head = next;
+    }
+}
+
+
+bool DoorMonitor::read(DoorEvent &event) {
+    /* Oldest event first, returns false when there is none */
+    bool available = false;
+
+    uint8_t oldSREG = SREG;
+    noInterrupts();
+    if (tail != head) {
+        event.pin = events[tail].pin;
+        event.open = events[tail].open;
+        event.time = events[tail].time;
+        unqueue(tail);
+        tail = (tail + 1) & (eventMax - 1);
+        available = true;
+    }
+    SREG = oldSREG;
+    return available;
+}
+
+
+bool DoorMonitor::pending() const {
+    return tail != head;
+}
+
+
+void DoorMonitor::clear() {
+    uint8_t oldSREG = SREG;
+    noInterrupts();
+    tail = head;
+    queuedOpen = 0;
+    queuedClosed = 0;
+    SREG = oldSREG;
+}
+
+
+void DoorMonitor::unqueue(byte index) {
+    /* Interrupts are off: the event leaves the ring */
+    if (events[index].open)
+        bitClear(queuedOpen, events[index].pin);
+    else
+        bitClear(queuedClosed, events[index].pin);
+}
+
+
+byte DoorMonitor::openDoors() const {
+    /* Levels as of the last edge */
+    return levels;
+}
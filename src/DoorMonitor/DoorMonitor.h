@@ -0,0 +1,64 @@
+//
+// Created by rafal on 17.10.2026.
+//
+
+#ifndef ARDUINO_CAMPER_CONTROLLER_DOORMONITOR_H
+#define ARDUINO_CAMPER_CONTROLLER_DOORMONITOR_H
+
+#include <Arduino.h>
+
+// The pin change interrupt is used on ATmega328/168, where digital pins 0-7
+// are PCINT16-23. Elsewhere poll() samples the pins from loop().
+#if defined(__AVR_ATmega328P__) || defined(__AVR_ATmega328__) || defined(__AVR_ATmega168__)
+#define DOOR_MONITOR_PCINT 1
+#else
+#define DOOR_MONITOR_PCINT 0
+#endif
+
+
+struct DoorEvent {
+    byte pin;
+    bool open;
+    // millis() when the edge was seen. An edge that wakes the CPU from
+    // power-down is timed half a watchdog period into the sleep.
+    unsigned long time;
+};
+
+
+/* Latches every edge of the door sensors on digital pins 0-7 into a ring
+   from the PCINT2 interrupt, so a door that opens and closes between two
+   loop() passes is not missed. A pin gets at most one unread open and one
+   unread close event, further edges only update openDoors(), so a
+   chattering sensor cannot push the other doors' events out of the ring.
+   When it is full anyway the oldest event is dropped. Sensors read HIGH
+   when the door is open. */
+class DoorMonitor {
+public:
+    static const byte eventMax = 8;     // power of two
+
+    explicit DoorMonitor(byte pinMask);
+
+    void begin();
+    void poll();
+
+    bool read(DoorEvent &event);
+    bool pending() const;
+    void clear();
+    byte openDoors() const;
+
+    void pinChange();
+
+private:
+    const byte pinMask;
+    volatile byte levels = 0;
+    volatile byte head = 0;
+    volatile byte tail = 0;
+    volatile byte queuedOpen = 0;       // pins with an open event in the ring
+    volatile byte queuedClosed = 0;
+    volatile DoorEvent events[eventMax];
+
+    byte readPins() const;
+    void unqueue(byte index);
+};
+
+#endif
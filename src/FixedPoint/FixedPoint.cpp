@@ -0,0 +1,38 @@
+//
+// Created by rafal on 17.10.2026.
+//
+
+#include "FixedPoint.h"
+
+
+namespace fixedpoint {
+
+    size_t print(Print &out, long milli, uint8_t decimals) {
+        /* Like Print::print(double, decimals) for the value / 1000, halves
+           round away from zero */
+        static const uint16_t steps[] = {1000, 100, 10, 1};
+        if (decimals > 3)
+            decimals = 3;
+
+        size_t n = 0;
+        unsigned long value;
+        if (milli < 0) {
+            n += out.print('-');
+            value = -(unsigned long) milli;
+        } else {
+            value = milli;
+        }
+
+        uint16_t step = steps[decimals];
+        value = (value + step / 2) / step;
+        if (decimals == 0)
+            return n + out.print(value);
+
+        uint16_t unit = 1000 / step;
+        n += out.print(value / unit);
+        n += out.print('.');
+        for (unit /= 10; unit > 0; unit /= 10)
+            n += out.print((char) ('0' + value / unit % 10));
+        return n;
+    }
+}
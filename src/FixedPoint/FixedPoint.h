@@ -0,0 +1,32 @@
+//
+// Created by rafal on 17.10.2026.
+//
+
+#ifndef ARDUINO_CAMPER_CONTROLLER_FIXEDPOINT_H
+#define ARDUINO_CAMPER_CONTROLLER_FIXEDPOINT_H
+
+#include <Arduino.h>
+#include <Print.h>
+
+
+/* Measurements kept as integer milli-units (mV, mA). An ADC result is
+   converted with one 16x16 bit multiply by a factor in 1/1024 steps that
+   is worked out at compile time from the full scale of the input. */
+namespace fixedpoint {
+
+    const uint8_t scaleShift = 10;
+
+    // Factor for scaled(): milli-units at the top of the ADC range / counts
+    constexpr uint16_t scale(uint32_t fullScaleMilli, uint16_t counts) {
+        return (uint16_t) (((fullScaleMilli << scaleShift) + counts / 2) / counts);
+    }
+
+    inline uint16_t scaled(uint16_t counts, uint16_t factor) {
+        return (uint16_t) (((uint32_t) counts * factor) >> scaleShift);
+    }
+
+    // Prints milli-units rounded to 0-3 decimals, e.g. 12604 as 12.60
+    size_t print(Print &out, long milli, uint8_t decimals = 2);
+}
+
+#endif
@@ -0,0 +1,67 @@
+#include <FixedPoint.h>
+
+// Counts CPU cycles with Timer1 running at F_CPU: converting three 12-bit
+// ADC results to volts with float arithmetic against millivolts with
+// fixedpoint::scaled(), then printing one value both ways.
+
+const uint32_t CONVERTER_MV = 25000;	// 0-25V divider to 0-5V
+const float CONVERTER_SCALE_FACTOR = 25.0 / 5;
+constexpr uint16_t SCALE = fixedpoint::scale(CONVERTER_MV, 4096);
+
+volatile uint16_t counts[3] = {2580, 2539, 12};
+volatile float volts[3];
+volatile uint16_t millivolts[3];
+
+// Discards the text, only the formatting is timed
+class NullPrint : public Print {
+public:
+	virtual size_t write(uint8_t) { return 1; }
+} sink;
+
+unsigned int cycles(void (*run)()) {
+	noInterrupts();
+	TCNT1 = 0;
+	run();
+	unsigned int count = TCNT1;
+	interrupts();
+	return count;
+}
+
+void floatConvert() {
+	for (byte i = 0; i < 3; i++)
+		volts[i] = counts[i] * (5.0 / 4096) * CONVERTER_SCALE_FACTOR;
+}
+
+void fixedConvert() {
+	for (byte i = 0; i < 3; i++)
+		millivolts[i] = fixedpoint::scaled(counts[i], SCALE);
+}
+
+void floatPrint() {
+	sink.print(volts[0]);
+}
+
+void fixedPrint() {
+	fixedpoint::print(sink, millivolts[0]);
+}
+
+void report(const char *name, unsigned int slow, unsigned int fast) {
+	Serial.print(name);
+	Serial.print(": float ");
+	Serial.print(slow);
+	Serial.print(" cycles, fixed ");
+	Serial.print(fast);
+	Serial.println(" cycles");
+}
+
+void setup() {
+	Serial.begin(115200);
+	TCCR1A = 0;
+	TCCR1B = _BV(CS10);	// no prescaler, one count per cycle
+}
+
+void loop() {
+	report("convert", cycles(floatConvert), cycles(fixedConvert));
+	report("print", cycles(floatPrint), cycles(fixedPrint));
+	delay(1000);
+}
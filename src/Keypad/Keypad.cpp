@@ -31,6 +31,16 @@
 */
 #include "Keypad.h"
 
+#if KEYPAD_TIMER_SCAN
+// Keypad scanned by the Timer0 compare B interrupt.
+static Keypad *backgroundKeypad = NULL;
+
+ISR(TIMER0_COMPB_vect) {
+	if (backgroundKeypad != NULL)
+		backgroundKeypad->backgroundScan();
+}
+#endif
+
 // <<constructor>> Allows custom keymap, pin configuration, and keypad sizes.
 Keypad::Keypad(char *userKeymap, byte *row, byte *col, byte numRows, byte numCols) {
 	rowPins = row;
@@ -43,9 +53,15 @@ Keypad::Keypad(char *userKeymap, byte *row, byte *col, byte numRows, byte numCol
 	setDebounceTime(10);
 	setHoldTime(500);
 	keypadEventListener = 0;
+	matrixScanner = 0;
 
 	startTime = 0;
 	single_key = false;
+
+	backgroundScanning = false;
+	eventHead = 0;
+	eventTail = 0;
+	scanTicks = 0;
 }
 
 // Let the user define a keymap - assume the same row/column count as defined in constructor
@@ -55,6 +71,16 @@ void Keypad::begin(char *userKeymap) {
 
 // Returns a single key only. Retained for backwards compatibility.
 char Keypad::getKey() {
+	// The interrupt keeps the key list, just report the next key press it queued.
+	if (backgroundScanning) {
+		KeyEvent event;
+		while (getEvent(event)) {
+			if (event.kstate == PRESSED)
+				return event.kchar;
+		}
+		return NO_KEY;
+	}
+
 	single_key = true;
 
 	if (getKeys() && key[0].stateChanged && (key[0].kstate==PRESSED))
@@ -69,6 +95,10 @@ char Keypad::getKey() {
 bool Keypad::getKeys() {
 	bool keyActivity = false;
 
+	// Already populated by the interrupt, report whether there is something to read.
+	if (backgroundScanning)
+		return eventHead != eventTail;
+
 	// Limit how often the keypad is scanned. This makes the loop() run 10 times as fast.
 	if ( (millis()-startTime)>debounceTime ) {
 		scanKeys();
@@ -81,6 +111,11 @@ bool Keypad::getKeys() {
 
 // Private : Hardware scan
 void Keypad::scanKeys() {
+	if (matrixScanner != NULL) {
+		matrixScanner(bitMap);
+		return;
+	}
+
 	// Re-intialize the row pins. Allows sharing these pins with other hardware.
 	for (byte r=0; r<sizeKpd.rows; r++) {
 		pin_mode(rowPins[r],INPUT_PULLUP);
@@ -100,26 +135,58 @@ void Keypad::scanKeys() {
 }
 
 // Manage the list without rearranging the keys. Returns true if any keys on the list changed state.
+// Only crossings that hold a listed key, or a pressed key while a slot is free, are visited.
 bool Keypad::updateList() {
 
 	bool anyActivity = false;
+	bool freeSlot = false;
+	byte listedKeys = 0;
+	uint listed[MAPSIZE];
 
-	// Delete any IDLE keys
+	for (byte r=0; r<sizeKpd.rows; r++) {
+		listed[r] = 0;
+	}
+
+	// Delete any IDLE keys and mark where the remaining ones sit in the matrix.
 	for (byte i=0; i<LIST_MAX; i++) {
 		if (key[i].kstate==IDLE) {
 			key[i].kchar = NO_KEY;
 			key[i].kcode = -1;
 			key[i].stateChanged = false;
 		}
+		if (key[i].kchar==NO_KEY) {
+			freeSlot = true;
+		}
+		else if (key[i].kcode >= 0) {
+			bitSet(listed[key[i].kcode / sizeKpd.columns], key[i].kcode % sizeKpd.columns);
+			listedKeys++;
+		}
+	}
+
+	// Nothing pressed and nothing to follow up on.
+	if (listedKeys == 0) {
+		uint pressed = 0;
+		for (byte r=0; r<sizeKpd.rows; r++) {
+			pressed |= bitMap[r];
+		}
+		if (pressed == 0)
+			return false;
 	}
 
 	// Add new keys to empty slots in the key list.
 	for (byte r=0; r<sizeKpd.rows; r++) {
-		for (byte c=0; c<sizeKpd.columns; c++) {
+		uint candidates = listed[r];
+		if (freeSlot)
+			candidates |= bitMap[r];
+
+		for (byte c=0; candidates; c++, candidates >>= 1) {
+			if (!(candidates & 1))
+				continue;
+
 			boolean button = bitRead(bitMap[r],c);
 			char keyChar = keymap[r * sizeKpd.columns + c];
 			int keyCode = r * sizeKpd.columns + c;
-			int idx = findInList (keyCode);
+			int idx = bitRead(listed[r],c) ? findInList (keyCode) : -1;
 			// Key is already on the list so set its next state.
 			if (idx > -1)	{
 				nextKeyState(idx, button);
@@ -244,10 +311,22 @@ void Keypad::addEventListener(void (*listener)(char)){
 	keypadEventListener = listener;
 }
 
+// Replace the pin_mode/pin_write/pin_read scan, e.g. with a PortScanner<>::scan
+// built for the same row and column pins.
+void Keypad::setMatrixScanner(void (*scanner)(uint *bitMap)){
+	matrixScanner = scanner;
+}
+
 void Keypad::transitionTo(byte idx, KeyState nextState) {
 	key[idx].kstate = nextState;
 	key[idx].stateChanged = true;
 
+	// Never call the listener from the interrupt, getEvent() does that.
+	if (backgroundScanning) {
+		pushEvent(key[idx].kchar, nextState);
+		return;
+	}
+
 	// Sketch used the getKey() function.
 	// Calls keypadEventListener only when the first key in slot 0 changes state.
 	if (single_key)  {
@@ -264,8 +343,80 @@ void Keypad::transitionTo(byte idx, KeyState nextState) {
 	}
 }
 
+// Start scanning from the timer interrupt. Debouncing keeps the same timing,
+// getKey() and getEvent() then only read the event queue and no longer depend
+// on how often loop() runs. Returns false if the board has no timer scan.
+bool Keypad::beginBackgroundScan() {
+#if KEYPAD_TIMER_SCAN
+	uint8_t oldSREG = SREG;
+	noInterrupts();
+	eventHead = 0;
+	eventTail = 0;
+	scanTicks = 0;
+	single_key = false;
+	backgroundKeypad = this;
+	backgroundScanning = true;
+	OCR0B = 0x80;				// Half way between two millis() overflows.
+	TIMSK0 |= _BV(OCIE0B);
+	SREG = oldSREG;
+	return true;
+#else
+	return false;
+#endif
+}
+
+void Keypad::endBackgroundScan() {
+#if KEYPAD_TIMER_SCAN
+	uint8_t oldSREG = SREG;
+	noInterrupts();
+	TIMSK0 &= ~_BV(OCIE0B);
+	backgroundKeypad = NULL;
+	backgroundScanning = false;
+	SREG = oldSREG;
+#endif
+}
+
+// Called every millisecond by the timer interrupt.
+void Keypad::backgroundScan() {
+	if (++scanTicks < debounceTime)
+		return;
+	scanTicks = 0;
+
+	scanKeys();
+	updateList();
+}
+
+// Take the oldest state change off the queue. Returns false if it is empty.
+bool Keypad::getEvent(KeyEvent &event) {
+	byte tail = eventTail;
+	if (tail == eventHead)
+		return false;
+
+	event.kchar = eventChar[tail & (EVENT_MAX - 1)];
+	event.kstate = eventState[tail & (EVENT_MAX - 1)];
+	eventTail = tail + 1;		// Hands the slot back to the interrupt.
+
+	if (keypadEventListener != NULL)
+		keypadEventListener(event.kchar);
+	return true;
+}
+
+// Interrupt side of the queue. Events are dropped while the queue is full.
+void Keypad::pushEvent(char keyChar, KeyState keyState) {
+	byte head = eventHead;
+	if ((byte)(head - eventTail) >= EVENT_MAX)
+		return;
+
+	eventChar[head & (EVENT_MAX - 1)] = keyChar;
+	eventState[head & (EVENT_MAX - 1)] = keyState;
+	eventHead = head + 1;		// Publish after the slot is written.
+}
+
 /*
 || @changelog
+|| | 3.2 2026-10-17 - rafal            : updateList() only visits listed and pressed keys.
+|| | 3.2 2026-10-17 - rafal            : Added setMatrixScanner() for compile time port scanners.
+|| | 3.2 2026-10-17 - rafal            : Added timer interrupt background scan with an event queue.
 || | 3.1 2013-01-15 - Mark Stanley     : Fixed missing RELEASED & IDLE status when using a single key.
 || | 3.0 2012-07-12 - Mark Stanley     : Made library multi-keypress by default. (Backwards compatible)
 || | 3.0 2012-07-12 - Mark Stanley     : Modified pin functions to support Keypad_I2C
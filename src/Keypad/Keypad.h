@@ -34,6 +34,7 @@
 #define KEYPAD_H
 
 #include "utility/Key.h"
+#include "utility/PortScanner.h"
 
 // Arduino versioning.
 #if defined(ARDUINO) && ARDUINO >= 100
@@ -75,8 +76,22 @@ typedef struct {
 
 #define LIST_MAX 10		// Max number of keys on the active list.
 #define MAPSIZE 10		// MAPSIZE is the number of rows (times 16 columns)
+#define EVENT_MAX 16	// Size of the background scan event queue, power of two.
 #define makeKeymap(x) ((char*)x)
 
+// Background scanning runs from the Timer0 compare B interrupt, which fires
+// once per millis() tick without changing Timer0. Define this to 0 if the
+// sketch needs TIMER0_COMPB_vect for something else.
+#if !defined(KEYPAD_TIMER_SCAN) && defined(__AVR__)
+#define KEYPAD_TIMER_SCAN 1
+#endif
+
+// A key state change recorded by the background scan.
+typedef struct {
+	char kchar;
+	KeyState kstate;
+} KeyEvent;
+
 
 //class Keypad : public Key, public HAL_obj {
 class Keypad : public Key {
@@ -105,6 +120,11 @@ public:
 	char waitForKey();
 	bool keyStateChanged();
 	byte numKeys();
+	bool beginBackgroundScan();
+	void endBackgroundScan();
+	bool getEvent(KeyEvent &event);
+	void backgroundScan();
+	void setMatrixScanner(void (*scanner)(uint *bitMap));
 
 private:
 	unsigned long startTime;
@@ -116,17 +136,30 @@ private:
 	uint holdTime;
 	bool single_key;
 
+	// Single producer (scan interrupt), single consumer (getKey/getEvent) queue.
+	volatile bool backgroundScanning;
+	volatile byte eventHead;
+	volatile byte eventTail;
+	volatile char eventChar[EVENT_MAX];
+	volatile KeyState eventState[EVENT_MAX];
+	uint scanTicks;
+
 	void scanKeys();
 	bool updateList();
 	void nextKeyState(byte n, boolean button);
 	void transitionTo(byte n, KeyState nextState);
+	void pushEvent(char keyChar, KeyState keyState);
 	void (*keypadEventListener)(char);
+	void (*matrixScanner)(uint *bitMap);
 };
 
 #endif
 
 /*
 || @changelog
+|| | 3.2 2026-10-17 - rafal            : updateList() only visits listed and pressed keys.
+|| | 3.2 2026-10-17 - rafal            : Added setMatrixScanner() for compile time port scanners.
+|| | 3.2 2026-10-17 - rafal            : Added timer interrupt background scan with an event queue.
 || | 3.1 2013-01-15 - Mark Stanley     : Fixed missing RELEASED & IDLE status when using a single key.
 || | 3.0 2012-07-12 - Mark Stanley     : Made library multi-keypress by default. (Backwards compatible)
 || | 3.0 2012-07-12 - Mark Stanley     : Modified pin functions to support Keypad_I2C
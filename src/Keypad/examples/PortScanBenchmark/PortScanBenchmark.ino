@@ -0,0 +1,69 @@
+#include <Keypad.h>
+
+// Counts CPU cycles of one full matrix scan with Timer1 running at F_CPU:
+// the pin_mode/pin_write/pin_read virtual calls used by scanKeys() against
+// the register level PortScanner for the same pins.
+
+const byte ROWS = 4; //four rows
+const byte COLS = 3; //three columns
+char keys[ROWS][COLS] = {
+	{'1','2','3'},
+	{'4','5','6'},
+	{'7','8','9'},
+	{'*','0','#'}
+};
+byte rowPins[ROWS] = {7, 8, 9, 10}; //connect to the row pinouts of the keypad
+byte colPins[COLS] = {11, 12, 13}; //connect to the column pinouts of the keypad
+
+typedef PortScanner<PinList<7, 8, 9, 10>, PinList<11, 12, 13> > Scanner;
+
+Keypad kpd = Keypad( makeKeymap(keys), rowPins, colPins, ROWS, COLS );
+Keypad *pins = &kpd;	// call through the vtable like scanKeys() does
+
+uint bitMap[ROWS];
+
+void virtualScan() {
+	for (byte r=0; r<ROWS; r++) {
+		pins->pin_mode(rowPins[r],INPUT_PULLUP);
+	}
+	for (byte c=0; c<COLS; c++) {
+		pins->pin_mode(colPins[c],OUTPUT);
+		pins->pin_write(colPins[c], LOW);
+		for (byte r=0; r<ROWS; r++) {
+			bitWrite(bitMap[r], c, !pins->pin_read(rowPins[r]));
+		}
+		pins->pin_write(colPins[c],HIGH);
+		pins->pin_mode(colPins[c],INPUT);
+	}
+}
+
+unsigned int cycles(void (*scan)()) {
+	noInterrupts();
+	TCNT1 = 0;
+	scan();
+	unsigned int count = TCNT1;
+	interrupts();
+	return count;
+}
+
+void portScan() {
+	Scanner::scan(bitMap);
+}
+
+void setup(){
+	Serial.begin(115200);
+	TCCR1A = 0;
+	TCCR1B = _BV(CS10);	// no prescaler, one count per cycle
+}
+
+void loop(){
+	unsigned int slow = cycles(virtualScan);
+	unsigned int fast = cycles(portScan);
+
+	Serial.print("virtual: ");
+	Serial.print(slow);
+	Serial.print(" cycles, port: ");
+	Serial.print(fast);
+	Serial.println(" cycles");
+	delay(1000);
+}
@@ -0,0 +1,179 @@
+/*
+||
+|| @file PortScanner.h
+|| @version 1.0
+|| @author rafal
+||
+|| @description
+|| | Matrix scan specialised at compile time on the row and column pins.
+|| | Ports and bit masks are resolved by the compiler, each column strobe
+|| | is a couple of sbi/cbi instructions and the rows are sampled with one
+|| | PINx read per port instead of a digitalRead() per crossing.
+|| |
+|| |   typedef PortScanner<PinList<7, 8, 9, 10>, PinList<11, 12, 13> > Scanner;
+|| |   keypad.setMatrixScanner(Scanner::scan);
+|| #
+||
+|| @license
+|| | This library is free software; you can redistribute it and/or
+|| | modify it under the terms of the GNU Lesser General Public
+|| | License as published by the Free Software Foundation; version
+|| | 2.1 of the License.
+|| #
+||
+*/
+
+#ifndef PORTSCANNER_H
+#define PORTSCANNER_H
+
+#include "Key.h"
+
+template<byte... Pins> struct PinList {};
+
+template<class Rows, class Columns> class PortScanner;
+
+#if defined(__AVR_ATmega328P__) || defined(__AVR_ATmega328__) || defined(__AVR_ATmega168__)
+
+namespace portscan {
+
+	// Uno pin numbering: D0-D7 on PORTD, D8-D13 on PORTB, A0-A5 on PORTC
+	enum { PORT_B, PORT_C, PORT_D };
+
+	constexpr byte portOf(byte pin) {
+		return pin < 8 ? PORT_D : (pin < 14 ? PORT_B : PORT_C);
+	}
+
+	constexpr byte maskOf(byte pin) {
+		return 1 << (pin < 8 ? pin : (pin < 14 ? pin - 8 : pin - 14));
+	}
+
+	template<byte Port> struct Registers;
+	template<> struct Registers<PORT_B> {
+		static volatile uint8_t &in() { return PINB; }
+		static volatile uint8_t &ddr() { return DDRB; }
+		static volatile uint8_t &out() { return PORTB; }
+	};
+	template<> struct Registers<PORT_C> {
+		static volatile uint8_t &in() { return PINC; }
+		static volatile uint8_t &ddr() { return DDRC; }
+		static volatile uint8_t &out() { return PORTC; }
+	};
+	template<> struct Registers<PORT_D> {
+		static volatile uint8_t &in() { return PIND; }
+		static volatile uint8_t &ddr() { return DDRD; }
+		static volatile uint8_t &out() { return PORTD; }
+	};
+
+	// Bits of the given port used by a pin list.
+	template<byte Port, byte... Pins> struct PortMask;
+	template<byte Port> struct PortMask<Port> {
+		static const byte value = 0;
+	};
+	template<byte Port, byte Pin, byte... Rest> struct PortMask<Port, Pin, Rest...> {
+		static const byte value = (portOf(Pin) == Port ? maskOf(Pin) : 0) | PortMask<Port, Rest...>::value;
+	};
+
+	// Switch all row pins of one port to INPUT_PULLUP with one write per register.
+	template<byte Port, byte Mask> struct RowSetup {
+		static inline void apply() {
+			if (Mask) {
+				Registers<Port>::ddr() &= ~Mask;
+				Registers<Port>::out() |= Mask;
+			}
+		}
+	};
+
+	template<byte Port, byte Mask> struct PortSample {
+		static inline byte read() { return Mask ? Registers<Port>::in() : 0; }
+	};
+
+	// Copy the sampled row levels into bit 'col' of bitMap[row].
+	template<byte... Pins> struct RowStore;
+	template<> struct RowStore<> {
+		static inline void store(uint *, byte, byte, byte, byte) {}
+	};
+	template<byte Pin, byte... Rest> struct RowStore<Pin, Rest...> {
+		static inline void store(uint *bitMap, byte col, byte pinb, byte pinc, byte pind) {
+			byte level = portOf(Pin) == PORT_B ? pinb : (portOf(Pin) == PORT_C ? pinc : pind);
+			bitWrite(*bitMap, col, !(level & maskOf(Pin)));	// keypress is active low
+			RowStore<Rest...>::store(bitMap + 1, col, pinb, pinc, pind);
+		}
+	};
+
+	template<class Rows, byte... Columns> struct ColumnStrobe;
+	template<byte... Rows> struct ColumnStrobe<PinList<Rows...> > {
+		static inline void scan(uint *, byte) {}
+	};
+	template<byte... Rows, byte Col, byte... Rest> struct ColumnStrobe<PinList<Rows...>, Col, Rest...> {
+		static inline void scan(uint *bitMap, byte col) {
+			typedef Registers<portOf(Col)> Column;
+
+			Column::out() &= ~maskOf(Col);		// Begin column pulse output.
+			Column::ddr() |= maskOf(Col);
+			__asm__ __volatile__ ("nop\n\tnop");	// Input synchroniser delay.
+
+			byte pinb = PortSample<PORT_B, PortMask<PORT_B, Rows...>::value>::read();
+			byte pinc = PortSample<PORT_C, PortMask<PORT_C, Rows...>::value>::read();
+			byte pind = PortSample<PORT_D, PortMask<PORT_D, Rows...>::value>::read();
+			RowStore<Rows...>::store(bitMap, col, pinb, pinc, pind);
+
+			// Drive high to recharge the rows, then high impedance like pinMode(INPUT).
+			Column::out() |= maskOf(Col);
+			Column::ddr() &= ~maskOf(Col);
+			Column::out() &= ~maskOf(Col);
+
+			ColumnStrobe<PinList<Rows...>, Rest...>::scan(bitMap, col + 1);
+		}
+	};
+
+}
+
+template<byte... Rows, byte... Columns>
+class PortScanner<PinList<Rows...>, PinList<Columns...> > {
+public:
+	static void scan(uint *bitMap) {
+		using namespace portscan;
+
+		// Re-intialize the row pins. Allows sharing these pins with other hardware.
+		RowSetup<PORT_B, PortMask<PORT_B, Rows...>::value>::apply();
+		RowSetup<PORT_C, PortMask<PORT_C, Rows...>::value>::apply();
+		RowSetup<PORT_D, PortMask<PORT_D, Rows...>::value>::apply();
+
+		ColumnStrobe<PinList<Rows...>, Columns...>::scan(bitMap, 0);
+	}
+};
+
+#else
+
+// Other boards: same interface, plain Arduino pin calls.
+template<byte... Rows, byte... Columns>
+class PortScanner<PinList<Rows...>, PinList<Columns...> > {
+public:
+	static void scan(uint *bitMap) {
+		const byte rows[] = { Rows... };
+		const byte columns[] = { Columns... };
+
+		for (byte r=0; r<sizeof(rows); r++) {
+			pinMode(rows[r], INPUT_PULLUP);
+		}
+		for (byte c=0; c<sizeof(columns); c++) {
+			pinMode(columns[c], OUTPUT);
+			digitalWrite(columns[c], LOW);
+			for (byte r=0; r<sizeof(rows); r++) {
+				bitWrite(bitMap[r], c, !digitalRead(rows[r]));
+			}
+			digitalWrite(columns[c], HIGH);
+			pinMode(columns[c], INPUT);
+		}
+	}
+};
+
+#endif
+
+#endif
+
+/*
+|| @changelog
+|| | 1.0 2026-10-17 - rafal : Initial Release
+|| #
+*/
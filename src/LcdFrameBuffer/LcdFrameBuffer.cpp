@@ -0,0 +1,103 @@
+//
+// Created by rafal on 17.10.2026.
+//
+
+#include "LcdFrameBuffer.h"
+
+
+LcdFrameBuffer::LcdFrameBuffer(LiquidCrystal_I2C &lcd)
+: lcd(lcd) {
+    clear();
+    invalidate();
+}
+
+
+void LcdFrameBuffer::clear() {
+    /* Blanks the back buffer, the display is untouched until flush() */
+    memset(back, ' ', sizeof(back));
+    col = 0;
+    row = 0;
+}
+
+
+void LcdFrameBuffer::setCursor(uint8_t col, uint8_t row) {
+    this->col = col;
+    this->row = row < rows ? row : rows - 1;
+}
+
+
+size_t LcdFrameBuffer::write(uint8_t value) {
+    // Like the display itself, text past the last column is swallowed
+    if (col < cols)
+        back[row][col] = value;
+    col++;
+    return 1;
+}
+
+
+void LcdFrameBuffer::invalidate() {
+    /* Forget what is on the display, e.g. after lcd.clear(), so the next
+       flush() redraws every cell */
+    memset(front, 0, sizeof(front));
+    lcdCol = unknownPosition;
+    lcdRow = unknownPosition;
+}
+
+
+uint8_t LcdFrameBuffer::flush() {
+    /* Sends the changed cells and returns the number of bytes it took */
+    frameBytes = 0;
+
+    for (uint8_t r = 0; r < rows; r++) {
+        for (uint8_t c = 0; c < cols; c++) {
+            if (back[r][c] == front[r][c])
+                continue;
+
+            // The display advances its cursor after each character, so
+            // only the first cell of a run needs an address command
+            if (c != lcdCol || r != lcdRow) {
+                lcd.setCursor(c, r);
+                frameBytes++;
+            }
+            lcd.write(back[r][c]);
+            frameBytes++;
+
+            front[r][c] = back[r][c];
+            lcdCol = c + 1;
+            lcdRow = r;
+        }
+    }
+
+    if (frameBytes > frameBytesMax)
+        frameBytesMax = frameBytes;
+    bytesSent += frameBytes;
+    frames++;
+    return frameBytes;
+}
+
+
+uint8_t LcdFrameBuffer::lastFrameBytes() const {
+    return frameBytes;
+}
+
+
+uint8_t LcdFrameBuffer::maxFrameBytes() const {
+    return frameBytesMax;
+}
+
+
+unsigned long LcdFrameBuffer::totalBytes() const {
+    return bytesSent;
+}
+
+
+unsigned long LcdFrameBuffer::frameCount() const {
+    return frames;
+}
+
+
+void LcdFrameBuffer::resetCounters() {
+    frameBytesMax = 0;
+    bytesSent = 0;
+    frames = 0;
+}
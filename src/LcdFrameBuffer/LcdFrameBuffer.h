@@ -0,0 +1,56 @@
+//
+// Created by rafal on 17.10.2026.
+//
+
+#ifndef ARDUINO_CAMPER_CONTROLLER_LCDFRAMEBUFFER_H
+#define ARDUINO_CAMPER_CONTROLLER_LCDFRAMEBUFFER_H
+
+#include <Arduino.h>
+#include <Print.h>
+
+#include "Arduino-LiquidCrystal-I2C-library-master/LiquidCrystal_I2C.h"
+
+
+/* Shadow copy of a 16x2 display. Text is printed into a back buffer and
+   flush() sends only the cells that differ from what the display already
+   shows, moving the cursor only where a run of changed cells starts. */
+class LcdFrameBuffer : public Print {
+public:
+    static const uint8_t cols = 16;
+    static const uint8_t rows = 2;
+
+    explicit LcdFrameBuffer(LiquidCrystal_I2C &lcd);
+
+    void clear();
+    void setCursor(uint8_t col, uint8_t row);
+    virtual size_t write(uint8_t value);
+    using Print::write;
+
+    void invalidate();
+    uint8_t flush();
+
+    // HD44780 bytes (characters and cursor commands) sent to the display
+    uint8_t lastFrameBytes() const;
+    uint8_t maxFrameBytes() const;
+    unsigned long totalBytes() const;
+    unsigned long frameCount() const;
+    void resetCounters();
+
+private:
+    static const uint8_t unknownPosition = 0xFF;
+
+    LiquidCrystal_I2C &lcd;
+    char back[rows][cols];
+    char front[rows][cols];
+    uint8_t col = 0;
+    uint8_t row = 0;
+    uint8_t lcdCol = unknownPosition;
+    uint8_t lcdRow = unknownPosition;
+
+    uint8_t frameBytes = 0;
+    uint8_t frameBytesMax = 0;
+    unsigned long bytesSent = 0;
+    unsigned long frames = 0;
+};
+
+#endif
@@ -141,20 +141,38 @@ sample code bearing this copyright.
 
 #include <Arduino.h>
 #include "OneWire.h"
-#include "OneWire/util/OneWire_direct_gpio.h"
 
 
 void OneWire::begin(uint8_t pin)
 {
-	pinMode(pin, INPUT);
-	bitmask = PIN_TO_BITMASK(pin);
-	baseReg = PIN_TO_BASEREG(pin);
+	engine.begin(pin);
+#if ONEWIRE_SLOT_COUNTER
+	slotCount = 0;
+#endif
 #if ONEWIRE_SEARCH
 	reset_search();
 #endif
 }
 
 
+// Run one transaction and wait for it.  The bus timing is done by the
+// transport, from Timer1 or the USART where the board has them, so
+// interrupts are held off for a few microseconds of each slot at most.
+static uint8_t transfer(OneWireTransport &engine, uint8_t flags, const uint8_t *out, uint16_t writeBits,
+		uint8_t *in, uint16_t readBits)
+{
+	OneWireTransaction transaction;
+	transaction.flags = flags;
+	transaction.out = out;
+	transaction.writeBits = writeBits;
+	transaction.in = in;
+	transaction.readBits = readBits;
+	transaction.done = 0;
+	transaction.context = 0;
+	return engine.run(transaction);
+}
+
+
 // Perform the onewire reset function.  We will wait up to 250uS for
 // the bus to come high, if it doesn't then it is broken or shorted
 // and we return a 0;
@@ -163,81 +181,36 @@ void OneWire::begin(uint8_t pin)
 //
 uint8_t OneWire::reset(void)
 {
-	IO_REG_TYPE mask IO_REG_MASK_ATTR = bitmask;
-	volatile IO_REG_TYPE *reg IO_REG_BASE_ATTR = baseReg;
-	uint8_t r;
-	uint8_t retries = 125;
-
-	noInterrupts();
-	DIRECT_MODE_INPUT(reg, mask);
-	interrupts();
-	// wait until the wire is high... just in case
-	do {
-		if (--retries == 0) return 0;
-		delayMicroseconds(2);
-	} while ( !DIRECT_READ(reg, mask));
-
-	noInterrupts();
-	DIRECT_WRITE_LOW(reg, mask);
-	DIRECT_MODE_OUTPUT(reg, mask);	// drive output low
-	interrupts();
-	delayMicroseconds(480);
-	noInterrupts();
-	DIRECT_MODE_INPUT(reg, mask);	// allow it to float
-	delayMicroseconds(70);
-	r = !DIRECT_READ(reg, mask);
-	interrupts();
-	delayMicroseconds(410);
-	return r;
+#if ONEWIRE_SLOT_COUNTER
+	slotCount++;
+#endif
+	return transfer(engine, ONEWIRE_RESET, 0, 0, 0, 0) == ONEWIRE_DONE;
 }
 
 //
-// Write a bit. Port and bit is used to cut lookup time and provide
-// more certain timing.
+// Write a bit.  The bus is left driven high.
 //
 void OneWire::write_bit(uint8_t v)
 {
-	IO_REG_TYPE mask IO_REG_MASK_ATTR = bitmask;
-	volatile IO_REG_TYPE *reg IO_REG_BASE_ATTR = baseReg;
-
-	if (v & 1) {
-		noInterrupts();
-		DIRECT_WRITE_LOW(reg, mask);
-		DIRECT_MODE_OUTPUT(reg, mask);	// drive output low
-		delayMicroseconds(10);
-		DIRECT_WRITE_HIGH(reg, mask);	// drive output high
-		interrupts();
-		delayMicroseconds(55);
-	} else {
-		noInterrupts();
-		DIRECT_WRITE_LOW(reg, mask);
-		DIRECT_MODE_OUTPUT(reg, mask);	// drive output low
-		delayMicroseconds(65);
-		DIRECT_WRITE_HIGH(reg, mask);	// drive output high
-		interrupts();
-		delayMicroseconds(5);
-	}
+	uint8_t bit = v & 1;
+
+#if ONEWIRE_SLOT_COUNTER
+	slotCount++;
+#endif
+	transfer(engine, ONEWIRE_POWER, &bit, 1, 0, 0);
 }
 
 //
-// Read a bit. Port and bit is used to cut lookup time and provide
-// more certain timing.
+// Read a bit.
 //
 uint8_t OneWire::read_bit(void)
 {
-	IO_REG_TYPE mask IO_REG_MASK_ATTR = bitmask;
-	volatile IO_REG_TYPE *reg IO_REG_BASE_ATTR = baseReg;
 	uint8_t r;
 
-	noInterrupts();
-	DIRECT_MODE_OUTPUT(reg, mask);
-	DIRECT_WRITE_LOW(reg, mask);
-	delayMicroseconds(3);
-	DIRECT_MODE_INPUT(reg, mask);	// let pin float, pull up will raise
-	delayMicroseconds(10);
-	r = DIRECT_READ(reg, mask);
-	interrupts();
-	delayMicroseconds(53);
+#if ONEWIRE_SLOT_COUNTER
+	slotCount++;
+#endif
+	transfer(engine, 0, 0, 0, &r, 1);
 	return r;
 }
 
@@ -249,46 +222,37 @@ uint8_t OneWire::read_bit(void)
 // other mishap.
 //
 void OneWire::write(uint8_t v, uint8_t power /* = 0 */) {
-    uint8_t bitMask;
-
-    for (bitMask = 0x01; bitMask; bitMask <<= 1) {
-	OneWire::write_bit( (bitMask & v)?1:0);
-    }
-    if ( !power) {
-	noInterrupts();
-	DIRECT_MODE_INPUT(baseReg, bitmask);
-	DIRECT_WRITE_LOW(baseReg, bitmask);
-	interrupts();
-    }
+#if ONEWIRE_SLOT_COUNTER
+    slotCount += 8;
+#endif
+    transfer(engine, power ? ONEWIRE_POWER : 0, &v, 8, 0, 0);
 }
 
 void OneWire::write_bytes(const uint8_t *buf, uint16_t count, bool power /* = 0 */) {
-  for (uint16_t i = 0 ; i < count ; i++)
-    write(buf[i]);
-  if (!power) {
-    noInterrupts();
-    DIRECT_MODE_INPUT(baseReg, bitmask);
-    DIRECT_WRITE_LOW(baseReg, bitmask);
-    interrupts();
-  }
+#if ONEWIRE_SLOT_COUNTER
+  slotCount += 8 * count;
+#endif
+  transfer(engine, power ? ONEWIRE_POWER : 0, buf, 8 * count, 0, 0);
 }
 
 //
 // Read a byte
 //
 uint8_t OneWire::read() {
-    uint8_t bitMask;
-    uint8_t r = 0;
+    uint8_t r;
 
-    for (bitMask = 0x01; bitMask; bitMask <<= 1) {
-	if ( OneWire::read_bit()) r |= bitMask;
-    }
+#if ONEWIRE_SLOT_COUNTER
+    slotCount += 8;
+#endif
+    transfer(engine, 0, 0, 0, &r, 8);
     return r;
 }
 
 void OneWire::read_bytes(uint8_t *buf, uint16_t count) {
-  for (uint16_t i = 0 ; i < count ; i++)
-    buf[i] = read();
+#if ONEWIRE_SLOT_COUNTER
+  slotCount += 8 * count;
+#endif
+  transfer(engine, 0, 0, 0, buf, 8 * count);
 }
 
 //
@@ -313,9 +277,7 @@ void OneWire::skip()
 
 void OneWire::depower()
 {
-	noInterrupts();
-	DIRECT_MODE_INPUT(baseReg, bitmask);
-	interrupts();
+	engine.depower();
 }
 
 #if ONEWIRE_SEARCH
@@ -51,14 +51,33 @@
 #define ONEWIRE_CRC16 1
 #endif
 
-// Board-specific macros for direct GPIO
-#include "OneWire/util/OneWire_direct_regtype.h"
+// You can count reset pulses and read/write time slots by defining this
+// to 1.  The counter costs a few cycles per slot and is meant for
+// measuring how much bus time higher level code needs.
+#ifndef ONEWIRE_SLOT_COUNTER
+#define ONEWIRE_SLOT_COUNTER 0
+#endif
+
+// Bus transport.  By default the pin is driven directly, timed from a
+// timer interrupt where the board has one (OneWireEngine.h).  Define
+// ONEWIRE_UART to 1 to generate the slots with USART0 instead
+// (OneWireUart.h); the pin given to OneWire is then ignored.
+#ifndef ONEWIRE_UART
+#define ONEWIRE_UART 0
+#endif
+
+#if ONEWIRE_UART
+#include "OneWire/OneWireUart.h"
+typedef OneWireUart OneWireTransport;
+#else
+#include "OneWire/OneWireEngine.h"
+typedef OneWireEngine OneWireTransport;
+#endif
 
 class OneWire
 {
   private:
-    IO_REG_TYPE bitmask;
-    volatile IO_REG_TYPE *baseReg;
+    OneWireTransport engine;
 
 #if ONEWIRE_SEARCH
     // global search state
@@ -68,11 +87,19 @@ class OneWire
     bool LastDeviceFlag;
 #endif
 
+#if ONEWIRE_SLOT_COUNTER
+    uint32_t slotCount;
+#endif
+
   public:
     OneWire() { }
     OneWire(uint8_t pin) { begin(pin); }
     void begin(uint8_t pin);
 
+    // The transport under the calls below, for queueing transactions
+    // without waiting for them.
+    OneWireTransport &getEngine(void) { return engine; }
+
     // Perform a 1-Wire reset cycle. Returns 1 if a device responds
     // with a presence pulse.  Returns 0 if there is no device or the
     // bus is shorted or otherwise held low for more than 250uS
@@ -111,6 +138,12 @@ class OneWire
     // someone shorts your bus.
     void depower(void);
 
+#if ONEWIRE_SLOT_COUNTER
+    // Number of reset pulses and bit slots since the last clearSlotCount().
+    uint32_t getSlotCount(void) const { return slotCount; }
+    void clearSlotCount(void) { slotCount = 0; }
+#endif
+
 #if ONEWIRE_SEARCH
     // Clear the search state so that if will start from the beginning again.
     void reset_search();
@@ -0,0 +1,358 @@
+/*
+1-Wire transaction engine.  The reset pulse and slot timings are the ones
+OneWire::reset(), write_bit() and read_bit() always used; on ATmega328/168
+the long parts of each slot are Timer1 compare waits instead of
+delayMicroseconds() with the CPU spinning.  Only the critical part of a
+slot (the 10us write-one pulse, the 3us read pulse and the 10us to the
+sample point) is still timed with the interrupt running, and so is the
+whole 65us write-zero pulse: ending it from a later compare interrupt,
+which the ADC, keypad, pin change or TWI interrupts can hold off, could
+stretch it past the 120us the DS18B20 allows for a zero.
+*/
+
+#include <Arduino.h>
+#include "OneWire.h"
+#include "OneWire/util/OneWire_direct_gpio.h"
+
+#if !ONEWIRE_UART
+
+void OneWireEngine::begin(uint8_t pin)
+{
+	pinMode(pin, INPUT);
+	bitmask = PIN_TO_BITMASK(pin);
+	baseReg = PIN_TO_BASEREG(pin);
+}
+
+
+void OneWireEngine::depower()
+{
+	noInterrupts();
+	DIRECT_MODE_INPUT(baseReg, bitmask);
+	interrupts();
+}
+
+
+uint8_t OneWireEngine::run(OneWireTransaction &transaction)
+{
+	while (!submit(transaction))
+		;
+	while (transaction.status == ONEWIRE_QUEUED || transaction.status == ONEWIRE_RUNNING)
+		yield();
+	return transaction.status;
+}
+
+
+#if ONEWIRE_ENGINE_TIMER
+
+// Timer1 runs free at F_CPU / 8 while an engine has work, 2 counts per us
+// at 16MHz.  Compare A marks the next edge.
+#define ONEWIRE_TICKS(us)	((uint16_t) ((us) * (F_CPU / 8000000UL)))
+
+enum {
+	PHASE_RESET_WAIT,	// waiting for the bus to float high
+	PHASE_RESET_RELEASE,	// end of the 480us reset pulse
+	PHASE_RESET_SAMPLE,	// presence pulse window
+	PHASE_SLOT		// start of the next slot
+};
+
+static OneWireEngine *timerEngine = 0;
+
+ISR(TIMER1_COMPA_vect) {
+	timerEngine->timerInterrupt();
+}
+
+static inline void schedule(uint16_t ticks)
+{
+	OCR1A = TCNT1 + ticks;
+	TIFR1 = _BV(OCF1A);
+}
+
+
+OneWireEngine::~OneWireEngine()
+{
+	uint8_t oldSREG = SREG;
+	noInterrupts();
+	if (timerEngine == this) {
+		TIMSK1 &= ~_BV(OCIE1A);
+		timerEngine = 0;
+	}
+	SREG = oldSREG;
+}
+
+
+bool OneWireEngine::submit(OneWireTransaction &transaction)
+{
+	uint8_t oldSREG = SREG;
+	noInterrupts();
+	if (timerEngine != 0 && timerEngine != this && !timerEngine->idle()) {
+		SREG = oldSREG;
+		return false;
+	}
+	transaction.status = ONEWIRE_QUEUED;
+	transaction.next = 0;
+	if (head) {
+		tail->next = &transaction;
+		tail = &transaction;
+	} else {
+		head = tail = &transaction;
+		timerEngine = this;
+		TCCR1A = 0;
+		TCCR1B = _BV(CS11);	// normal mode, clk/8
+		start();
+		TIMSK1 |= _BV(OCIE1A);
+	}
+	SREG = oldSREG;
+	return true;
+}
+
+
+// Interrupts are off: from submit() or the timer interrupt
+void OneWireEngine::start()
+{
+	OneWireTransaction *transaction = head;
+	transaction->status = ONEWIRE_RUNNING;
+	bit = 0;
+	if (transaction->flags & ONEWIRE_RESET) {
+		phase = PHASE_RESET_WAIT;
+		retries = 25;
+	} else {
+		phase = PHASE_SLOT;
+	}
+	schedule(ONEWIRE_TICKS(10));
+}
+
+
+void OneWireEngine::finish(uint8_t status)
+{
+	OneWireTransaction *transaction = head;
+	if (!(transaction->flags & ONEWIRE_POWER)) {
+		DIRECT_MODE_INPUT(baseReg, bitmask);
+		DIRECT_WRITE_LOW(baseReg, bitmask);
+	}
+
+	// The next one starts before the callback, which may submit again
+	head = transaction->next;
+	if (head)
+		start();
+	else
+		TIMSK1 &= ~_BV(OCIE1A);
+
+	transaction->status = status;
+	if (transaction->done)
+		transaction->done(transaction);
+}
+
+
+void OneWireEngine::timerInterrupt()
+{
+	IO_REG_TYPE mask IO_REG_MASK_ATTR = bitmask;
+	volatile IO_REG_TYPE *reg IO_REG_BASE_ATTR = baseReg;
+
+	switch (phase) {
+	case PHASE_RESET_WAIT:
+		// wait up to 250uS for the wire to be high... just in case
+		if (!DIRECT_READ(reg, mask)) {
+			if (--retries == 0)
+				finish(ONEWIRE_NO_PRESENCE);
+			else
+				schedule(ONEWIRE_TICKS(10));
+			return;
+		}
+		DIRECT_WRITE_LOW(reg, mask);
+		DIRECT_MODE_OUTPUT(reg, mask);	// drive output low
+		phase = PHASE_RESET_RELEASE;
+		schedule(ONEWIRE_TICKS(480));
+		return;
+
+	case PHASE_RESET_RELEASE:
+		DIRECT_MODE_INPUT(reg, mask);	// allow it to float
+		phase = PHASE_RESET_SAMPLE;
+		schedule(ONEWIRE_TICKS(70));
+		return;
+
+	case PHASE_RESET_SAMPLE:
+		// No presence pulse ends the transaction after the reset time
+		if (DIRECT_READ(reg, mask))
+			bit = 0xFFFF;
+		phase = PHASE_SLOT;
+		schedule(ONEWIRE_TICKS(410));
+		return;
+
+	default:
+		nextSlot();
+		return;
+	}
+}
+
+
+void OneWireEngine::nextSlot()
+{
+	IO_REG_TYPE mask IO_REG_MASK_ATTR = bitmask;
+	volatile IO_REG_TYPE *reg IO_REG_BASE_ATTR = baseReg;
+	OneWireTransaction *transaction = head;
+
+	if (bit == 0xFFFF) {
+		finish(ONEWIRE_NO_PRESENCE);
+	} else if (bit < transaction->writeBits) {
+		uint8_t v = transaction->out[bit >> 3] & (1 << (bit & 7));
+		bit++;
+		DIRECT_WRITE_LOW(reg, mask);
+		DIRECT_MODE_OUTPUT(reg, mask);	// drive output low
+		if (v) {
+			delayMicroseconds(10);
+			DIRECT_WRITE_HIGH(reg, mask);	// drive output high
+			schedule(ONEWIRE_TICKS(55));
+		} else {
+			delayMicroseconds(65);
+			DIRECT_WRITE_HIGH(reg, mask);	// drive output high
+			schedule(ONEWIRE_TICKS(5));
+		}
+	} else if (bit < transaction->writeBits + transaction->readBits) {
+		uint16_t n = bit - transaction->writeBits;
+		bit++;
+		DIRECT_MODE_OUTPUT(reg, mask);
+		DIRECT_WRITE_LOW(reg, mask);
+		delayMicroseconds(3);
+		DIRECT_MODE_INPUT(reg, mask);	// let pin float, pull up will raise
+		delayMicroseconds(10);
+		uint8_t r = DIRECT_READ(reg, mask);
+		if ((n & 7) == 0)
+			transaction->in[n >> 3] = 0;
+		if (r)
+			transaction->in[n >> 3] |= 1 << (n & 7);
+		schedule(ONEWIRE_TICKS(53));
+	} else {
+		finish(ONEWIRE_DONE);
+	}
+}
+
+#else
+
+bool OneWireEngine::submit(OneWireTransaction &transaction)
+{
+	transaction.next = 0;
+	transaction.status = ONEWIRE_QUEUED;
+	execute(&transaction);
+	return true;
+}
+
+
+void OneWireEngine::execute(OneWireTransaction *transaction)
+{
+	uint8_t status = ONEWIRE_DONE;
+
+	transaction->status = ONEWIRE_RUNNING;
+	if ((transaction->flags & ONEWIRE_RESET) && !resetPulse()) {
+		status = ONEWIRE_NO_PRESENCE;
+	} else {
+		for (uint16_t i = 0; i < transaction->writeBits; i++)
+			writeSlot(transaction->out[i >> 3] & (1 << (i & 7)));
+		for (uint16_t i = 0; i < transaction->readBits; i++) {
+			if ((i & 7) == 0)
+				transaction->in[i >> 3] = 0;
+			if (readSlot())
+				transaction->in[i >> 3] |= 1 << (i & 7);
+		}
+	}
+	if (!(transaction->flags & ONEWIRE_POWER)) {
+		noInterrupts();
+		DIRECT_MODE_INPUT(baseReg, bitmask);
+		DIRECT_WRITE_LOW(baseReg, bitmask);
+		interrupts();
+	}
+
+	transaction->status = status;
+	if (transaction->done)
+		transaction->done(transaction);
+}
+
+
+// Perform the onewire reset function.  We will wait up to 250uS for
+// the bus to come high, if it doesn't then it is broken or shorted
+// and we return a 0;
+//
+// Returns 1 if a device asserted a presence pulse, 0 otherwise.
+//
+uint8_t OneWireEngine::resetPulse(void)
+{
+	IO_REG_TYPE mask IO_REG_MASK_ATTR = bitmask;
+	volatile IO_REG_TYPE *reg IO_REG_BASE_ATTR = baseReg;
+	uint8_t r;
+	uint8_t retries = 125;
+
+	noInterrupts();
+	DIRECT_MODE_INPUT(reg, mask);
+	interrupts();
+	// wait until the wire is high... just in case
+	do {
+		if (--retries == 0) return 0;
+		delayMicroseconds(2);
+	} while ( !DIRECT_READ(reg, mask));
+
+	noInterrupts();
+	DIRECT_WRITE_LOW(reg, mask);
+	DIRECT_MODE_OUTPUT(reg, mask);	// drive output low
+	interrupts();
+	delayMicroseconds(480);
+	noInterrupts();
+	DIRECT_MODE_INPUT(reg, mask);	// allow it to float
+	delayMicroseconds(70);
+	r = !DIRECT_READ(reg, mask);
+	interrupts();
+	delayMicroseconds(410);
+	return r;
+}
+
+//
+// Write a bit. Port and bit is used to cut lookup time and provide
+// more certain timing.
+//
+void OneWireEngine::writeSlot(uint8_t v)
+{
+	IO_REG_TYPE mask IO_REG_MASK_ATTR = bitmask;
+	volatile IO_REG_TYPE *reg IO_REG_BASE_ATTR = baseReg;
+
+	if (v) {
+		noInterrupts();
+		DIRECT_WRITE_LOW(reg, mask);
+		DIRECT_MODE_OUTPUT(reg, mask);	// drive output low
+		delayMicroseconds(10);
+		DIRECT_WRITE_HIGH(reg, mask);	// drive output high
+		interrupts();
+		delayMicroseconds(55);
+	} else {
+		noInterrupts();
+		DIRECT_WRITE_LOW(reg, mask);
+		DIRECT_MODE_OUTPUT(reg, mask);	// drive output low
+		delayMicroseconds(65);
+		DIRECT_WRITE_HIGH(reg, mask);	// drive output high
+		interrupts();
+		delayMicroseconds(5);
+	}
+}
+
+//
+// Read a bit. Port and bit is used to cut lookup time and provide
+// more certain timing.
+//
+uint8_t OneWireEngine::readSlot(void)
+{
+	IO_REG_TYPE mask IO_REG_MASK_ATTR = bitmask;
+	volatile IO_REG_TYPE *reg IO_REG_BASE_ATTR = baseReg;
+	uint8_t r;
+
+	noInterrupts();
+	DIRECT_MODE_OUTPUT(reg, mask);
+	DIRECT_WRITE_LOW(reg, mask);
+	delayMicroseconds(3);
+	DIRECT_MODE_INPUT(reg, mask);	// let pin float, pull up will raise
+	delayMicroseconds(10);
+	r = DIRECT_READ(reg, mask);
+	interrupts();
+	delayMicroseconds(53);
+	return r;
+}
+
+#endif
+
+#endif
@@ -0,0 +1,81 @@
+#ifndef OneWireEngine_h
+#define OneWireEngine_h
+
+#ifdef __cplusplus
+
+#include <stdint.h>
+
+// Runs 1-Wire transactions from the Timer1 compare A interrupt on
+// ATmega328/168, and on the host core, which emulates Timer1, so the CPU
+// is free between slot edges.  Elsewhere a transaction runs to completion
+// inside submit(), with the same waveform as the bit-banged OneWire
+// always had.  Define this to 0 if the sketch needs Timer1 for something
+// else.
+#if !defined(ONEWIRE_ENGINE_TIMER) && (defined(__AVR_ATmega328P__) || defined(__AVR_ATmega328__) || defined(__AVR_ATmega168__) || defined(ARDUINO_ARCH_HOST))
+#define ONEWIRE_ENGINE_TIMER 1
+#endif
+#ifndef ONEWIRE_ENGINE_TIMER
+#define ONEWIRE_ENGINE_TIMER 0
+#endif
+
+#include "OneWire/OneWireTransaction.h"
+
+// Board-specific macros for direct GPIO
+#include "OneWire/util/OneWire_direct_regtype.h"
+
+class OneWireEngine
+{
+  private:
+	IO_REG_TYPE bitmask;
+	volatile IO_REG_TYPE *baseReg;
+
+	// Transactions are run in submit() order from a linked queue
+	OneWireTransaction *volatile head;
+	OneWireTransaction *tail;
+
+#if ONEWIRE_ENGINE_TIMER
+	// Position of the interrupt in the current transaction
+	uint8_t phase;
+	uint8_t retries;
+	uint16_t bit;
+
+	void start();
+	void finish(uint8_t status);
+	void nextSlot();
+#else
+	uint8_t resetPulse(void);
+	void writeSlot(uint8_t v);
+	uint8_t readSlot(void);
+	void execute(OneWireTransaction *transaction);
+#endif
+
+  public:
+	OneWireEngine() : head(0), tail(0) { }
+#if ONEWIRE_ENGINE_TIMER
+	// Gives Timer1 up if this engine has it, dropping what is queued
+	~OneWireEngine();
+#endif
+	void begin(uint8_t pin);
+
+	// Queues a transaction.  Timer1 serves one engine at a time, so
+	// this returns false while another engine still has work queued.
+	bool submit(OneWireTransaction &transaction);
+
+	// True when no transaction is queued or running
+	bool idle() const { return head == 0; }
+
+	// Submits and waits for the end, returns the final status.  The
+	// blocking OneWire calls are built on this.
+	uint8_t run(OneWireTransaction &transaction);
+
+	// Leaves the bus floating, for after an ONEWIRE_POWER transaction
+	void depower(void);
+
+#if ONEWIRE_ENGINE_TIMER
+	// Called from the Timer1 compare A interrupt
+	void timerInterrupt();
+#endif
+};
+
+#endif // __cplusplus
+#endif // OneWireEngine_h
@@ -0,0 +1,42 @@
+#ifndef OneWireTransaction_h
+#define OneWireTransaction_h
+
+#ifdef __cplusplus
+
+#include <stdint.h>
+
+// One exchange on the bus: an optional reset pulse, writeBits bits from
+// out, then readBits bits into in, both LSB first.  The struct must stay
+// alive until status is no longer ONEWIRE_QUEUED or ONEWIRE_RUNNING.
+struct OneWireTransaction
+{
+	uint8_t flags;			// ONEWIRE_RESET, ONEWIRE_POWER
+	const uint8_t *out;
+	uint16_t writeBits;
+	uint8_t *in;
+	uint16_t readBits;
+
+	// Called when the transaction ends, from the Timer1 or USART
+	// interrupt on ATmega328/168.  May be 0, the status can be polled
+	// instead.
+	void (*done)(OneWireTransaction *transaction);
+	void *context;
+
+	volatile uint8_t status;
+	OneWireTransaction *next;
+};
+
+// Transaction flags
+#define ONEWIRE_RESET	0x01	// start with a reset pulse and check for presence
+#define ONEWIRE_POWER	0x02	// leave the bus driven high at the end, see OneWire::write(),
+				// not possible with the UART transport
+
+// Transaction status
+#define ONEWIRE_QUEUED		0
+#define ONEWIRE_RUNNING		1
+#define ONEWIRE_DONE		2
+#define ONEWIRE_NO_PRESENCE	3	// no device answered the reset, or the bus is held low
+#define ONEWIRE_BUS_ERROR	4	// the bus was held low through a slot, UART transport only
+
+#endif // __cplusplus
+#endif // OneWireTransaction_h
@@ -0,0 +1,158 @@
+/*
+1-Wire transport on USART0, see OneWireUart.h.  Built when ONEWIRE_UART is
+set, the timings follow Maxim application note 214.  The host core emulates
+USART0 on pins 0 and 1, host/sim/onewire_uart_check runs it against the
+DS18B20 models.
+*/
+
+#include <Arduino.h>
+#include "OneWire.h"
+
+#if ONEWIRE_UART
+
+#if !defined(__AVR_ATmega328P__) && !defined(__AVR_ATmega328__) && !defined(__AVR_ATmega168__) \
+	&& !defined(ARDUINO_ARCH_HOST)
+#error "OneWireUart needs USART0 of an ATmega328/168"
+#endif
+
+// UBRR0 in double speed mode, rounded to the nearest rate
+#define ONEWIRE_UBRR(baud)	((F_CPU / 8 + (baud) / 2) / (baud) - 1)
+
+static OneWireUart *uartBus = 0;
+
+ISR(USART_RX_vect) {
+	uint8_t status = UCSR0A;	// before UDR0, which clears it
+	uint8_t echo = UDR0;
+	if (uartBus != 0)
+		uartBus->received(echo, status & _BV(FE0));
+}
+
+
+void OneWireUart::begin(uint8_t pin)
+{
+	(void) pin;
+	uartBus = this;
+	UBRR0 = ONEWIRE_UBRR(115200);
+	UCSR0A = _BV(U2X0);
+	UCSR0C = _BV(UCSZ01) | _BV(UCSZ00);	// 8N1
+	UCSR0B = _BV(RXCIE0) | _BV(RXEN0) | _BV(TXEN0);
+}
+
+
+bool OneWireUart::submit(OneWireTransaction &transaction)
+{
+	uint8_t oldSREG = SREG;
+	noInterrupts();
+	transaction.status = ONEWIRE_QUEUED;
+	transaction.next = 0;
+	if (head) {
+		tail->next = &transaction;
+		tail = &transaction;
+	} else {
+		head = tail = &transaction;
+		start();
+	}
+	SREG = oldSREG;
+	return true;
+}
+
+
+uint8_t OneWireUart::run(OneWireTransaction &transaction)
+{
+	submit(transaction);
+	while (transaction.status == ONEWIRE_QUEUED || transaction.status == ONEWIRE_RUNNING)
+		;
+	return transaction.status;
+}
+
+
+// Interrupts are off: from submit() or the RX interrupt
+void OneWireUart::start()
+{
+	OneWireTransaction *transaction = head;
+	transaction->status = ONEWIRE_RUNNING;
+	bit = 0;
+	if (transaction->flags & ONEWIRE_RESET) {
+		resetting = true;
+		UBRR0 = ONEWIRE_UBRR(9600);
+		UDR0 = 0xF0;
+	} else {
+		resetting = false;
+		nextSlot();
+	}
+}
+
+
+void OneWireUart::finish(uint8_t status)
+{
+	OneWireTransaction *transaction = head;
+
+	// The next one starts before the callback, which may submit again
+	head = transaction->next;
+	if (head)
+		start();
+
+	transaction->status = status;
+	if (transaction->done)
+		transaction->done(transaction);
+}
+
+
+void OneWireUart::nextSlot()
+{
+	OneWireTransaction *transaction = head;
+
+	if (bit < transaction->writeBits) {
+		UDR0 = transaction->out[bit >> 3] & (1 << (bit & 7)) ? 0xFF : 0x00;
+		bit++;
+	} else if (bit < transaction->writeBits + transaction->readBits) {
+		UDR0 = 0xFF;
+		bit++;
+	} else {
+		finish(ONEWIRE_DONE);
+	}
+}
+
+
+void OneWireUart::received(uint8_t echo, bool framingError)
+{
+	OneWireTransaction *transaction = head;
+	if (transaction == 0)
+		return;
+
+	if (resetting) {
+		// Unchanged echo: nobody there.  Framing error: bus held low.
+		resetting = false;
+		UBRR0 = ONEWIRE_UBRR(115200);
+		if (echo == 0xF0 || framingError)
+			finish(ONEWIRE_NO_PRESENCE);
+		else
+			nextSlot();
+		return;
+	}
+
+	uint16_t last = bit - 1;
+	if (framingError) {
+		// The stop bit read low, the bus is held down and the echo is
+		// no zero from a device.  The bits not read yet read as ones,
+		// like an empty bus, so the zeros don't pass a CRC check.
+		uint16_t n = last < transaction->writeBits ? 0 : last - transaction->writeBits;
+		for (; n < transaction->readBits; n++) {
+			if ((n & 7) == 0)
+				transaction->in[n >> 3] = 0;
+			transaction->in[n >> 3] |= 1 << (n & 7);
+		}
+		finish(ONEWIRE_BUS_ERROR);
+		return;
+	}
+	if (last >= transaction->writeBits) {
+		uint16_t n = last - transaction->writeBits;
+		if ((n & 7) == 0)
+			transaction->in[n >> 3] = 0;
+		if (echo == 0xFF)
+			transaction->in[n >> 3] |= 1 << (n & 7);
+	}
+	nextSlot();
+}
+
+#endif
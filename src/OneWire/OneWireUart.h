@@ -0,0 +1,57 @@
+#ifndef OneWireUart_h
+#define OneWireUart_h
+
+#ifdef __cplusplus
+
+#include <stdint.h>
+
+#include "OneWire/OneWireTransaction.h"
+
+// 1-Wire transport on USART0 of an ATmega328/168, for boards where the
+// bus hangs on RX (pin 0) and TX (pin 1) drives it through an open-drain
+// stage or a Schottky diode.  The shift register times every slot:
+//
+//   reset   9600 baud, send 0xF0: 520us low, a presence pulse pulls
+//           some of the high bits down, the echo is no longer 0xF0
+//   slot    115200 baud, one byte per bit: 0x00 writes a zero (78us
+//           low), 0xFF writes a one or reads, the echo is 0xFF when the
+//           device sent a one
+//
+// Each echo ends in the RX complete interrupt, which starts the next
+// slot, so interrupts are never held off.  An echo with a framing error
+// means the bus is held low: a reset ends with ONEWIRE_NO_PRESENCE, a
+// slot with ONEWIRE_BUS_ERROR and the bits not read yet as ones.  TX can
+// only pull the bus low, ONEWIRE_POWER is ignored and parasite powered
+// sensors need their own strong pull-up.  Serial cannot be used at the
+// same time.
+class OneWireUart
+{
+  private:
+	// Transactions are run in submit() order from a linked queue
+	OneWireTransaction *volatile head;
+	OneWireTransaction *tail;
+
+	uint16_t bit;
+	bool resetting;
+
+	void start();
+	void finish(uint8_t status);
+	void nextSlot();
+
+  public:
+	OneWireUart() : head(0), tail(0) { }
+
+	// The pin is ignored, the bus is always on RX/TX
+	void begin(uint8_t pin);
+
+	bool submit(OneWireTransaction &transaction);
+	bool idle() const { return head == 0; }
+	uint8_t run(OneWireTransaction &transaction);
+	void depower(void) { }
+
+	// Called from the USART RX complete interrupt with the echo
+	void received(uint8_t echo, bool framingError);
+};
+
+#endif // __cplusplus
+#endif // OneWireUart_h
@@ -0,0 +1,55 @@
+#include <OneWire.h>
+
+// Reads the scratchpad of one DS18B20 (skip ROM) twice, blocking and as a
+// queued OneWireTransaction, and counts how often loop() code could have
+// run meanwhile. With the Timer1 engine the CPU only stays busy for the
+// short part of each slot.
+
+OneWire ds(A3);
+
+uint8_t readCommand[2] = {0xCC, 0xBE};	// skip ROM, read scratchpad
+uint8_t scratchpad[9];
+volatile bool finished;
+
+void done(OneWireTransaction *transaction) {
+	finished = true;	// interrupt context
+}
+
+void setup() {
+	Serial.begin(115200);
+}
+
+void loop() {
+	unsigned long start = micros();
+	ds.reset();
+	ds.write_bytes(readCommand, sizeof(readCommand));
+	ds.read_bytes(scratchpad, sizeof(scratchpad));
+	unsigned long blocking = micros() - start;
+
+	OneWireTransaction transaction;
+	transaction.flags = ONEWIRE_RESET;
+	transaction.out = readCommand;
+	transaction.writeBits = 8 * sizeof(readCommand);
+	transaction.in = scratchpad;
+	transaction.readBits = 8 * sizeof(scratchpad);
+	transaction.done = done;
+	transaction.context = 0;
+
+	finished = false;
+	unsigned long spins = 0;
+	start = micros();
+	ds.getEngine().submit(transaction);
+	while (!finished)
+		spins++;	// the rest of the sketch would run here
+	unsigned long queued = micros() - start;
+
+	Serial.print("blocking: ");
+	Serial.print(blocking);
+	Serial.print(" us, queued: ");
+	Serial.print(queued);
+	Serial.print(" us with ");
+	Serial.print(spins);
+	Serial.print(" free loop passes, crc ");
+	Serial.println(OneWire::crc8(scratchpad, 8) == scratchpad[8] ? "ok" : "bad");
+	delay(1000);
+}
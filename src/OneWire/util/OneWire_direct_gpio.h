@@ -1,8 +1,8 @@
 #ifndef OneWire_Direct_GPIO_h
 #define OneWire_Direct_GPIO_h
 
-// This header should ONLY be included by OneWire.cpp.  These defines are
-// meant to be private, used within OneWire.cpp, but not exposed to Arduino
+// This header should ONLY be included by OneWireEngine.cpp.  These defines are
+// meant to be private, used within OneWireEngine.cpp, but not exposed to Arduino
 // sketches or other libraries which may include OneWire.h.
 
 #include <stdint.h>
@@ -406,14 +406,16 @@ void directWriteHigh(IO_REG_TYPE mask)
 #define PIN_TO_BASEREG(PIN)             (0)
 #define PIN_TO_BITMASK(PIN)             (PIN)
 #define IO_REG_TYPE unsigned int
-#define IO_REG_BASE_ATTR
+#define IO_REG_BASE_ATTR __attribute__ ((unused))
 #define IO_REG_MASK_ATTR
 #define DIRECT_READ(base, PIN)          digitalRead(PIN)
 #define DIRECT_WRITE_LOW(base, PIN)     digitalWrite(PIN, LOW)
 #define DIRECT_WRITE_HIGH(base, PIN)    digitalWrite(PIN, HIGH)
 #define DIRECT_MODE_INPUT(base, PIN)    pinMode(PIN,INPUT)
 #define DIRECT_MODE_OUTPUT(base, PIN)   pinMode(PIN,OUTPUT)
+#if !defined(ARDUINO_ARCH_HOST)	/* host builds simulate the bus through these calls */
 #warning "OneWire. Fallback mode. Using API calls for pinMode,digitalRead and digitalWrite. Operation of this library is not guaranteed on this architecture."
+#endif
 
 #endif
 
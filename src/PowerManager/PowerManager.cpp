@@ -0,0 +1,193 @@
+//
+// Created by rafal on 17.10.2026.
+//
+
+#include "PowerManager.h"
+#include "FixedPoint/FixedPoint.h"
+
+#if POWER_MANAGER_AVR || defined(ARDUINO_ARCH_HOST)
+#include <avr/sleep.h>
+#include <avr/wdt.h>
+#endif
+
+#if POWER_MANAGER_AVR
+
+// Kept by the Timer0 overflow interrupt in wiring.c
+extern "C" volatile unsigned long timer0_millis;
+
+static volatile bool watchdogFired;
+
+ISR(WDT_vect) {
+    watchdogFired = true;
+}
+
+// Only there to wake the CPU, the keypad scan picks up the key itself.
+// PCINT2 belongs to the DoorMonitor, which ignores pins it doesn't watch.
+EMPTY_INTERRUPT(PCINT0_vect);
+#endif
+
+
+PowerManager::PowerManager(byte wakePinsB, byte wakePinsD, const byte *drivePins, byte driveCount)
+: wakePinsB(wakePinsB), wakePinsD(wakePinsD), drivePins(drivePins), driveCount(driveCount) {
+}
+
+
+void PowerManager::begin() {
+    resetReport();
+}
+
+
+void PowerManager::idle(Scheduler &scheduler) {
+    unsigned long start = micros();
+    scheduler.idle();
+    idleTime += micros() - start;
+}
+
+
+PowerManager::Wake PowerManager::powerDown() {
+    for (byte i = 0; i < driveCount; i++) {
+        digitalWrite(drivePins[i], LOW);
+        pinMode(drivePins[i], OUTPUT);
+    }
+
+    Wake wake = sleepPowerDown();
+
+    /* Back to high impedance, as the keypad scan leaves its columns */
+    for (byte i = 0; i < driveCount; i++)
+        pinMode(drivePins[i], INPUT);
+
+    if (wake == WATCHDOG) {
+        watchdogWakes++;
+    } else {
+        pinWakes++;
+        pinWakeTime = millis();
+    }
+    return wake;
+}
+
+
+bool PowerManager::settling() const {
+    return pinWakes && millis() - pinWakeTime < settleTime;
+}
+
+
+PowerManager::Wake PowerManager::sleepPowerDown() {
+#if POWER_MANAGER_AVR
+    /* Same pattern as Scheduler::idle(): interrupts off from arming the
+       wake sources to the sleep instruction */
+    noInterrupts();
+    byte pcmsk0 = PCMSK0;
+    byte pcmsk2 = PCMSK2;
+    byte pcicr = PCICR;
+    PCMSK0 |= wakePinsB;
+    PCMSK2 |= wakePinsD;
+    // A door edge since noInterrupts() stays pending for the DoorMonitor
+    PCIFR = pcicr & _BV(PCIE2) ? _BV(PCIF0) : _BV(PCIF0) | _BV(PCIF2);
+    PCICR |= (wakePinsB ? _BV(PCIE0) : 0) | (wakePinsD ? _BV(PCIE2) : 0);
+
+    // With a door edge pending there is no point sleeping, it wakes us now
+    Wake wake = PIN_CHANGE;
+    unsigned long slept = 0;
+    if (!(PCIFR & _BV(PCIF2))) {
+        // Interrupt only watchdog, 250 ms
+        watchdogFired = false;
+        wdt_reset();
+        WDTCSR = _BV(WDCE) | _BV(WDE);
+        WDTCSR = _BV(WDIE) | _BV(WDP2);
+
+        /* Timer0 stands still while asleep: move millis() on by the time
+           slept. A pin change comes anywhere in the period and counts half
+           of it, added before sleeping so that the interrupt that wakes
+           the CPU already stamps its door event with it. A watchdog wake
+           adds the other half. micros() is not corrected. */
+        slept = watchdogPeriod / 2;
+        timer0_millis += slept;
+
+        set_sleep_mode(SLEEP_MODE_PWR_DOWN);
+        sleep_enable();
+#ifdef sleep_bod_disable
+        sleep_bod_disable();
+#endif
+        interrupts();
+        sleep_cpu();
+        sleep_disable();
+
+        noInterrupts();
+        wdt_disable();
+        if (watchdogFired) {
+            wake = WATCHDOG;
+            timer0_millis += watchdogPeriod - slept;
+            slept = watchdogPeriod;
+        }
+    }
+    PCICR = pcicr;
+    PCMSK0 = pcmsk0;
+    PCMSK2 = pcmsk2;
+    interrupts();
+
+    powerDownTime += slept;
+    return wake;
+#elif defined(ARDUINO_ARCH_HOST)
+    /* The host core's power-down ends at the watchdog timeout or, like a
+       pin change interrupt, at the next input change. millis() there is
+       the simulator's clock and needs no correction. */
+    unsigned long start = millis();
+    wdt_enable(WDTO_250MS);
+    set_sleep_mode(SLEEP_MODE_PWR_DOWN);
+    sleep_enable();
+    sleep_cpu();
+    sleep_disable();
+    wdt_disable();
+
+    unsigned long slept = millis() - start;
+    powerDownTime += slept;
+    return slept < watchdogPeriod ? PIN_CHANGE : WATCHDOG;
+#else
+    delay(watchdogPeriod);
+    powerDownTime += watchdogPeriod;
+    return WATCHDOG;
+#endif
+}
+
+
+void PowerManager::printReport(Print &out) const {
+    /* Time and share in each mode, wake-ups by source and the average
+       current of the MCU alone (not the LCD, relays or sensors) */
+    unsigned long total = millis() - reportStart;
+    unsigned long idle = idleTime / 1000;
+    unsigned long awake = total - idle - powerDownTime;
+    float share = total ? 100.0f / total : 0;
+
+    out.print(F("power awake="));
+    out.print(awake);
+    out.print(F(" ms "));
+    out.print(awake * share, 1);
+    out.print(F("% idle="));
+    out.print(idle);
+    out.print(F(" ms "));
+    out.print(idle * share, 1);
+    out.print(F("% down="));
+    out.print(powerDownTime);
+    out.print(F(" ms "));
+    out.print(powerDownTime * share, 1);
+    out.println('%');
+
+    float current = total ? ((float) awake * activeCurrent + (float) idle * idleCurrent
+                             + (float) powerDownTime * powerDownCurrent) / total : 0;
+    out.print(F("wakes watchdog="));
+    out.print(watchdogWakes);
+    out.print(F(" pin="));
+    out.print(pinWakes);
+    out.print(F(" avg="));
+    fixedpoint::print(out, (long) current);
+    out.println(F(" mA"));
+}
+
+
+void PowerManager::resetReport() {
+    reportStart = millis();
+    idleTime = 0;
+    powerDownTime = 0;
+    watchdogWakes = 0;
+    pinWakes = 0;
+}
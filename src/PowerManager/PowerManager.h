@@ -0,0 +1,80 @@
+//
+// Created by rafal on 17.10.2026.
+//
+
+#ifndef ARDUINO_CAMPER_CONTROLLER_POWERMANAGER_H
+#define ARDUINO_CAMPER_CONTROLLER_POWERMANAGER_H
+
+#include <Arduino.h>
+#include <Print.h>
+
+#include "Scheduler/Scheduler.h"
+
+// Power-down with watchdog and pin change wake on ATmega328/168. Elsewhere
+// powerDown() waits one watchdog period, or less on the host simulator
+// when an input changes.
+#if defined(__AVR_ATmega328P__) || defined(__AVR_ATmega328__) || defined(__AVR_ATmega168__)
+#define POWER_MANAGER_AVR 1
+#else
+#define POWER_MANAGER_AVR 0
+#endif
+
+
+/* Picks between the two sleep modes and keeps a duty cycle account.
+
+   idle() is SLEEP_MODE_IDLE through the scheduler: timers, ADC and TWI keep
+   running and any interrupt wakes the CPU, at the latest the next millis()
+   tick. powerDown() stops every clock but the watchdog. The CPU wakes
+   after one watchdog period (250 ms), or on a pin change on wakePinsB /
+   wakePinsD (pins 8-13 / 0-7). drivePins are pulled LOW while asleep, e.g.
+   keypad columns, so a key press pulls its row and counts as a pin change.
+   millis() is moved on by the time slept, a whole period for the watchdog
+   and half of one (the expected value) for a pin change, which the
+   watchdog's +-10% makes no worse. The Uno has no 32 kHz crystal for an
+   asynchronous Timer2, so the watchdog is the only timer left running. */
+class PowerManager {
+public:
+    static const unsigned int watchdogPeriod = 250;     // ms
+    static const unsigned int settleTime = 50;          // ms awake after a pin change
+
+    enum Wake {
+        WATCHDOG,
+        PIN_CHANGE
+    };
+
+    PowerManager(byte wakePinsB, byte wakePinsD, const byte *drivePins, byte driveCount);
+
+    void begin();
+    void idle(Scheduler &scheduler);
+    Wake powerDown();
+    // A pin woke the CPU less than settleTime ago. Power-down stops the
+    // timers that debounce the keypad and buttons, wait for them.
+    bool settling() const;
+
+    // Time awake, idle and powered down since begin() / resetReport(),
+    // with the average current the ATmega328P datasheet puts on it
+    void printReport(Print &out) const;
+    void resetReport();
+
+private:
+    // Supply current at 16 MHz and 5 V, uA
+    static const unsigned long activeCurrent = 10000;
+    static const unsigned long idleCurrent = 2500;
+    static const unsigned long powerDownCurrent = 10;   // watchdog on
+
+    const byte wakePinsB;
+    const byte wakePinsD;
+    const byte *drivePins;
+    const byte driveCount;
+
+    unsigned long pinWakeTime = 0;
+    unsigned long reportStart = 0;
+    unsigned long idleTime = 0;         // us
+    unsigned long powerDownTime = 0;    // ms
+    unsigned long watchdogWakes = 0;
+    unsigned long pinWakes = 0;
+
+    Wake sleepPowerDown();
+};
+
+#endif
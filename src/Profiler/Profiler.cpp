@@ -0,0 +1,89 @@
+//
+// Created by rafal on 17.10.2026.
+//
+
+#include "Profiler.h"
+
+
+ProfileSection *ProfileSection::first = nullptr;
+ProfileSection *ProfileSection::last = nullptr;
+
+
+ProfileSection::ProfileSection(const char *name)
+: name(name) {
+    reset();
+
+    if (last)
+        last->next = this;
+    else
+        first = this;
+    last = this;
+}
+
+
+void ProfileSection::add(unsigned long duration) {
+    if (count == 0 || duration < shortest)
+        shortest = duration;
+    if (duration > longest)
+        longest = duration;
+    count++;
+    total += duration;
+
+    uint8_t bucket = 0;
+    while (bucket < buckets - 1 && (duration >> bucket))
+        bucket++;
+    if (histogram[bucket] != 0xFFFF)
+        histogram[bucket]++;
+}
+
+
+void ProfileSection::reset() {
+    count = 0;
+    total = 0;
+    shortest = 0;
+    longest = 0;
+    memset(histogram, 0, sizeof(histogram));
+}
+
+
+void ProfileSection::print(Print &out) const {
+    /* name n=count min/avg/max us, then the non-empty buckets as <limit:count,
+       the last bucket takes everything longer */
+    out.print(name);
+    out.print(F(" n="));
+    out.print(count);
+    out.print(' ');
+    out.print(shortest);
+    out.print('/');
+    out.print(count ? total / count : 0);
+    out.print('/');
+    out.print(longest);
+    out.print(F(" us"));
+
+    for (uint8_t i = 0; i < buckets; i++) {
+        if (!histogram[i])
+            continue;
+        if (i < buckets - 1) {
+            out.print(F(" <"));
+            out.print(1UL << i);
+        } else {
+            out.print(F(" >="));
+            out.print(1UL << (i - 1));
+        }
+        out.print(':');
+        out.print(histogram[i]);
+    }
+    out.println();
+}
+
+
+void ProfileSection::printAll(Print &out) {
+    for (ProfileSection *section = first; section; section = section->next)
+        section->print(out);
+}
+
+
+void ProfileSection::resetAll() {
+    for (ProfileSection *section = first; section; section = section->next)
+        section->reset();
+}
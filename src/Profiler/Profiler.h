@@ -0,0 +1,73 @@
+//
+// Created by rafal on 17.10.2026.
+//
+
+#ifndef ARDUINO_CAMPER_CONTROLLER_PROFILER_H
+#define ARDUINO_CAMPER_CONTROLLER_PROFILER_H
+
+#include <Arduino.h>
+#include <Print.h>
+
+// Time spent in instrumented sections of loop(). Off by default, with
+// LOOP_PROFILER 0 the macros below expand to nothing.
+#ifndef LOOP_PROFILER
+#define LOOP_PROFILER 0
+#endif
+
+
+/* Accumulates micros() durations of one code section: count, min/avg/max
+   and a log2 histogram, bucket k counting durations below 2^k us. */
+class ProfileSection {
+public:
+    static const uint8_t buckets = 16;
+
+    explicit ProfileSection(const char *name);
+
+    void add(unsigned long duration);
+    void reset();
+    void print(Print &out) const;
+
+    // Every section in the sketch, in definition order
+    static void printAll(Print &out);
+    static void resetAll();
+
+private:
+    static ProfileSection *first;
+    static ProfileSection *last;
+
+    ProfileSection *next = nullptr;
+    const char *name;
+    unsigned long count = 0;
+    unsigned long total = 0;
+    unsigned long shortest = 0;
+    unsigned long longest = 0;
+    uint16_t histogram[buckets];
+};
+
+
+/* Adds the time from construction to destruction to a section */
+class ProfileScope {
+public:
+    explicit ProfileScope(ProfileSection &section)
+    : section(section), start(micros()) {
+    }
+
+    ~ProfileScope() {
+        section.add(micros() - start);
+    }
+
+private:
+    ProfileSection &section;
+    const unsigned long start;
+};
+
+
+#if LOOP_PROFILER
+#define PROFILE_SECTION(section, name) ProfileSection section(name)
+#define PROFILE_SCOPE(section) ProfileScope section##Scope(section)
+#else
+#define PROFILE_SECTION(section, name)
+#define PROFILE_SCOPE(section)
+#endif
+
+#endif
@@ -0,0 +1,149 @@
+//
+// Created by rafal on 17.10.2026.
+//
+
+#include "Scheduler.h"
+
+#if SCHEDULER_SLEEP
+#include <avr/sleep.h>
+#endif
+
+
+Scheduler::Scheduler(Task *tasks, byte count)
+: tasks(tasks), count(count > taskMax ? taskMax : count) {
+}
+
+
+void Scheduler::begin(unsigned long time) {
+    /* Everything is due at once and runs in table order, which is already
+       a valid heap */
+    for (byte i = 0; i < count; i++) {
+        tasks[i].deadline = time;
+        heap[i] = i;
+    }
+    resetStats();
+}
+
+
+byte Scheduler::runDue() {
+    /* Runs every task that is due by now, earliest deadline first */
+    byte ran = 0;
+    if (count == 0)
+        return ran;
+
+    unsigned long now = millis();
+    while ((long) (now - tasks[heap[0]].deadline) >= 0) {
+        Task &task = tasks[heap[0]];
+        if (now - task.deadline >= task.period)
+            task.late++;
+
+        unsigned long start = micros();
+        task.run();
+        unsigned long duration = micros() - start;
+
+        task.runs++;
+        if (duration > task.longest)
+            task.longest = duration;
+        if (duration > task.budget)
+            task.overruns++;
+
+        task.deadline += task.period;
+        if ((long) (task.deadline - now) <= 0)
+            task.deadline = now + task.period;
+        siftDown(0);
+
+        ran++;
+        now = millis();
+    }
+    return ran;
+}
+
+
+void Scheduler::idle() {
+#if SCHEDULER_SLEEP
+    /* Interrupts stay off from the check to the sleep instruction, so one
+       that makes work can't slip in between; sei takes effect only after
+       the next instruction. Any interrupt wakes the CPU, at the latest the
+       Timer0 overflow that drives millis(). */
+    set_sleep_mode(SLEEP_MODE_IDLE);
+    noInterrupts();
+    if (timeToNext() > 0) {
+        sleep_enable();
+        interrupts();
+        sleep_cpu();
+        sleep_disable();
+    }
+    interrupts();
+#else
+    unsigned long wait = timeToNext();
+    if (wait > 0)
+        delay(wait);
+#endif
+}
+
+
+unsigned long Scheduler::timeToNext() const {
+    if (count == 0)
+        return 0;
+    long remaining = tasks[heap[0]].deadline - millis();
+    return remaining > 0 ? remaining : 0;
+}
+
+
+bool Scheduler::before(byte a, byte b) const {
+    long difference = tasks[a].deadline - tasks[b].deadline;
+    return difference < 0 || (difference == 0 && a < b);
+}
+
+
+void Scheduler::siftDown(byte position) {
+    while (true) {
+        byte smallest = position;
+        byte left = 2 * position + 1;
+        byte right = left + 1;
+        if (left < count && before(heap[left], heap[smallest]))
+            smallest = left;
+        if (right < count && before(heap[right], heap[smallest]))
+            smallest = right;
+        if (smallest == position)
+            return;
+
+        byte swap = heap[position];
+        heap[position] = heap[smallest];
+        heap[smallest] = swap;
+        position = smallest;
+    }
+}
+
+
+void Scheduler::printStats(Print &out) const {
+    /* name n=runs max us, then overruns and late starts when there are any */
+    for (byte i = 0; i < count; i++) {
+        const Task &task = tasks[i];
+        out.print((const __FlashStringHelper *) task.name);
+        out.print(F(" n="));
+        out.print(task.runs);
+        out.print(F(" max="));
+        out.print(task.longest);
+        out.print(F(" us"));
+        if (task.overruns) {
+            out.print(F(" over="));
+            out.print(task.overruns);
+        }
+        if (task.late) {
+            out.print(F(" late="));
+            out.print(task.late);
+        }
+        out.println();
+    }
+}
+
+
+void Scheduler::resetStats() {
+    for (byte i = 0; i < count; i++) {
+        tasks[i].runs = 0;
+        tasks[i].longest = 0;
+        tasks[i].overruns = 0;
+        tasks[i].late = 0;
+    }
+}
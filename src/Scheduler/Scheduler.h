@@ -0,0 +1,73 @@
+//
+// Created by rafal on 17.10.2026.
+//
+
+#ifndef ARDUINO_CAMPER_CONTROLLER_SCHEDULER_H
+#define ARDUINO_CAMPER_CONTROLLER_SCHEDULER_H
+
+#include <Arduino.h>
+#include <Print.h>
+
+// Idle sleep between tasks on AVR and in the host simulator, whose core
+// sleeps to the next millis() tick or input change. Elsewhere idle() waits
+// out the time to the next deadline with delay().
+#if defined(__AVR__) || defined(ARDUINO_ARCH_HOST)
+#define SCHEDULER_SLEEP 1
+#else
+#define SCHEDULER_SLEEP 0
+#endif
+
+
+/* A periodic job. name (in PROGMEM), run, period and budget are set in the
+   task table, the rest is kept by the Scheduler. */
+struct Task {
+    Task(const char *name, void (*run)(), unsigned int period, unsigned int budget)
+    : name(name), run(run), period(period), budget(budget),
+      deadline(0), runs(0), longest(0), overruns(0), late(0) {
+    }
+
+    const char *name;
+    void (*run)();
+    unsigned int period;        // ms
+    unsigned int budget;        // us a run may take
+
+    unsigned long deadline;     // millis() of the next run
+    unsigned long runs;
+    unsigned long longest;      // us
+    unsigned int overruns;      // runs longer than budget
+    unsigned int late;          // started a whole period or more after deadline
+};
+
+
+/* Cooperative scheduler over a fixed task table. The tasks sit in a binary
+   min-heap on their deadlines (ties go to the earlier table entry), so
+   runDue() looks only at the top to know whether anything is due. A task
+   runs to completion and is rescheduled one period after its deadline;
+   when that is already past it skips to one period from now and counts as
+   late. */
+class Scheduler {
+public:
+    static const byte taskMax = 16;
+
+    Scheduler(Task *tasks, byte count);
+
+    void begin(unsigned long time);
+    byte runDue();
+    void idle();
+
+    // Milliseconds to the next deadline, 0 if a task is due
+    unsigned long timeToNext() const;
+
+    void printStats(Print &out) const;
+    void resetStats();
+
+private:
+    Task *const tasks;
+    const byte count;
+    byte heap[taskMax];
+
+    bool before(byte a, byte b) const;
+    void siftDown(byte position);
+};
+
+#endif
@@ -0,0 +1,104 @@
+//
+// Created by rafal on 17.10.2026.
+//
+
+#ifndef ARDUINO_CAMPER_CONTROLLER_STATEMACHINE_H
+#define ARDUINO_CAMPER_CONTROLLER_STATEMACHINE_H
+
+#include <stddef.h>
+
+
+/* One row of a transition table: in state from, event moves the machine
+   to state to when guard (if any) returns true, running action (if any)
+   on the way. */
+template<typename State, typename Event>
+struct Transition {
+    State from;
+    Event event;
+    State to;
+    bool (*guard)();
+    void (*action)();
+};
+
+
+/* Rows are tried in table order, the first one that matches wins. The
+   recursion unrolls the table at compile time, so for each row the state
+   and event compare against constants and guard/action are direct calls,
+   which is what a hand-written switch compiles to. */
+template<typename Table, size_t Row, size_t Rows>
+struct TransitionRow {
+    static bool dispatch(typename Table::State &state, typename Table::Event event) {
+        constexpr const Transition<typename Table::State, typename Table::Event> &row = Table::transitions[Row];
+        if (state == row.from && event == row.event && (row.guard == nullptr || row.guard())) {
+            if (row.action != nullptr)
+                row.action();
+            state = row.to;
+            return true;
+        }
+        return TransitionRow<Table, Row + 1, Rows>::dispatch(state, event);
+    }
+};
+
+template<typename Table, size_t Rows>
+struct TransitionRow<Table, Rows, Rows> {
+    static bool dispatch(typename Table::State &, typename Table::Event) {
+        return false;
+    }
+};
+
+
+/* A row can never fire when an earlier row for the same state and event
+   has no guard. For static_assert on a table. */
+template<typename Table>
+constexpr bool rowShadowed(size_t row, size_t earlier = 0) {
+    return earlier < row
+           && ((Table::transitions[earlier].from == Table::transitions[row].from
+                && Table::transitions[earlier].event == Table::transitions[row].event
+                && Table::transitions[earlier].guard == nullptr)
+               || rowShadowed<Table>(row, earlier + 1));
+}
+
+template<typename Table>
+constexpr bool rowsReachable(size_t row = 0) {
+    return row == Table::rows || (!rowShadowed<Table>(row) && rowsReachable<Table>(row + 1));
+}
+
+
+/* Table provides the State and Event enums, a constexpr transitions[]
+   array of Transition<State, Event> with its length as rows, and a
+   constexpr activities[] with a function (or nullptr) for each state. */
+template<typename Table>
+class StateMachine {
+public:
+    typedef typename Table::State State;
+    typedef typename Table::Event Event;
+
+    explicit StateMachine(State initial)
+    : current(initial) {
+    }
+
+    // False when no row of the table took the event
+    bool dispatch(Event event) {
+        return TransitionRow<Table, 0, Table::rows>::dispatch(current, event);
+    }
+
+    // What the current state does on every pass
+    void run() {
+        void (*activity)() = Table::activities[current];
+        if (activity != nullptr)
+            activity();
+    }
+
+    State state() const {
+        return current;
+    }
+
+    void reset(State initial) {
+        current = initial;
+    }
+
+private:
+    State current;
+};
+
+#endif
@@ -0,0 +1,320 @@
+//
+// Created by rafal on 17.10.2026.
+//
+
+#include "TemperatureService.h"
+
+
+const uint8_t TemperatureService::maxSensors;
+// How often the bus is asked whether the conversion is done, every poll is a read slot
+const uint8_t TemperatureService::pollInterval = 10;
+// More than one 9 bit step between two readings, C
+const float TemperatureService::fastChange = 0.5f;
+// Closer than this to a limit, C
+const float TemperatureService::nearLimit = 3.0f;
+
+// DS18x20 commands, see DallasTemperature.cpp
+static const uint8_t SKIP_ROM = 0xCC;
+static const uint8_t MATCH_ROM = 0x55;
+static const uint8_t CONVERT_T = 0x44;
+static const uint8_t READ_SCRATCHPAD = 0xBE;
+static const uint8_t WRITE_SCRATCHPAD = 0x4E;
+
+
+TemperatureService::TemperatureService(DallasTemperature &sensors, const Config *config, uint8_t count)
+: sensors(sensors), bus(sensors.getOneWire()->getEngine()), config(config), count(min(count, maxSensors)) {
+    for (uint8_t i = 0; i < maxSensors; i++)
+        slots[i].temperature = DEVICE_DISCONNECTED_C;
+    transaction.out = out;
+    transaction.in = in;
+    transaction.done = 0;
+    transaction.context = 0;
+    transaction.status = ONEWIRE_DONE;
+}
+
+
+void TemperatureService::begin() {
+    /* Blocking calls for the setup, update() queues everything after */
+    sensors.begin();
+
+    // maxResolution goes to the EEPROM too, it is what a sensor comes back
+    // at after losing power, see readDone(). Later settings only go to the
+    // scratchpad, see writeResolution().
+    found = min(sensors.getDeviceCount(), count);
+    for (uint8_t i = 0; i < found; i++) {
+        Sensor &sensor = slots[i];
+        sensors.getAddress(sensor.address, i);
+        sensors.setResolution(sensor.address, config[i].maxResolution, true);
+        uint8_t scratchPad[9];
+        sensors.readScratchPad(sensor.address, scratchPad);
+        memcpy(sensor.alarms, scratchPad + 2, sizeof(sensor.alarms));
+        // A DS18S20 has no resolution setting and always takes the 12 bit time
+        sensor.resolution = sensor.address[0] == DS18S20MODEL ? 12 : constrain(config[i].maxResolution, 9, 12);
+        sensor.target = sensor.resolution;
+    }
+    if (found)
+        requestConversion(bit(found) - 1, millis());
+}
+
+
+bool TemperatureService::update() {
+    /* Returns true when a new temperature has been read */
+    if (transaction.status == ONEWIRE_QUEUED || transaction.status == ONEWIRE_RUNNING)
+        return false;
+    unsigned long now = millis();
+    bool read = collect(now);
+
+    switch (state) {
+        case IDLE: {
+            if (writeResolution())
+                break;
+
+            uint8_t mask = 0;
+            for (uint8_t i = 0; i < found; i++) {
+                if (now - slots[i].readTime >= config[i].period)
+                    bitSet(mask, i);
+            }
+            if (mask)
+                requestConversion(mask, now);
+            break;
+        }
+
+        case CONVERTING:
+            readNext(now);
+            break;
+    }
+    return read;
+}
+
+
+void TemperatureService::setAdaptive(bool enabled) {
+    adaptive = enabled;
+    if (enabled)
+        return;
+    for (uint8_t i = 0; i < found; i++) {
+        if (slots[i].address[0] != DS18S20MODEL)
+            slots[i].target = constrain(config[i].maxResolution, 9, 12);
+    }
+}
+
+
+uint8_t TemperatureService::sensorCount() const {
+    return found;
+}
+
+
+float TemperatureService::getTemperature(uint8_t sensor) const {
+    return sensor < maxSensors ? slots[sensor].temperature : DEVICE_DISCONNECTED_C;
+}
+
+
+uint8_t TemperatureService::getResolution(uint8_t sensor) const {
+    return sensor < found ? slots[sensor].resolution : 0;
+}
+
+
+bool TemperatureService::isConverting() const {
+    return state == CONVERTING;
+}
+
+
+void TemperatureService::requestConversion(uint8_t mask, unsigned long now) {
+    /* Every sensor on the bus converts, only the due ones are read */
+    unsigned int longest = 0;
+    for (uint8_t i = 0; i < found; i++) {
+        if (bitRead(mask, i)) {
+            slots[i].conversionTime = sensors.millisToWaitForConversion(slots[i].resolution);
+            longest = max(longest, slots[i].conversionTime);
+        }
+    }
+
+    // Parasite powered sensors lose their supply with the first read, so
+    // none is read before the slowest is done
+    if (sensors.isParasitePowerMode()) {
+        for (uint8_t i = 0; i < found; i++)
+            slots[i].conversionTime = longest;
+    }
+
+    // Parasite powered sensors convert on the bus driven high
+    out[0] = SKIP_ROM;
+    out[1] = CONVERT_T;
+    if (!submit(CONVERT, ONEWIRE_RESET | (sensors.isParasitePowerMode() ? ONEWIRE_POWER : 0), 2, 0))
+        return;
+    due = mask;
+    requested = mask;
+    allConverted = false;
+    requestTime = now;
+    pollTime = now;
+    state = CONVERTING;
+}
+
+
+bool TemperatureService::conversionDone(unsigned long now) {
+    /* True once every sensor on the bus is done */
+    if (allConverted)
+        return true;
+
+    // Parasite powered sensors cannot answer while converting
+    if (sensors.isParasitePowerMode() || !sensors.getCheckForConversion())
+        return false;
+
+    // Sensors only answer read slots straight after the Convert T command,
+    // after the first scratchpad read the bus just floats high
+    if (due != requested)
+        return false;
+
+    if (now - pollTime < pollInterval)
+        return false;
+    // One read slot, 1 once every sensor is done; collect() takes it
+    if (submit(POLL, 0, 0, 1))
+        pollTime = now;
+    return false;
+}
+
+
+void TemperatureService::readNext(unsigned long now) {
+    /* Queues the scratchpad read of the due sensor whose conversion ends
+       first, once it has */
+    uint8_t next = found;
+    for (uint8_t i = 0; i < found; i++) {
+        if (bitRead(due, i) && (next == found || slots[i].conversionTime < slots[next].conversionTime))
+            next = i;
+    }
+    if (next == found) {
+        state = IDLE;
+        return;
+    }
+    if (now - requestTime < slots[next].conversionTime && !conversionDone(now))
+        return;
+
+    uint8_t length = select(next);
+    out[length++] = READ_SCRATCHPAD;
+    submit(READ, ONEWIRE_RESET, length, 8 * sizeof(in));
+}
+
+
+bool TemperatureService::readDone() {
+    /* The scratchpad read by the last transaction. The period counts from
+       the request. */
+    uint8_t index = exchangeSensor;
+    Sensor &sensor = slots[index];
+    uint8_t resolution = 0;
+    int16_t raw = DEVICE_DISCONNECTED_RAW;
+    if (transaction.status == ONEWIRE_DONE)
+        raw = DallasTemperature::decodeScratchPad(sensor.address, in, &resolution);
+    float temperature = DallasTemperature::rawToCelsius(raw);
+    bitClear(due, index);
+    if (!due)
+        state = IDLE;
+
+    if (resolution && resolution != sensor.resolution) {
+        /* The sensor lost power and came back at its EEPROM setting, so it
+           was read before that conversion was done and holds an old or the
+           85 C power-on value. Drop the reading, it is out of this cycle.
+           Its readTime stays as it was, so the next IDLE update finds it
+           due at once and writes the target back before converting. */
+        sensor.resolution = resolution;
+        return false;
+    }
+    if (resolution)
+        memcpy(sensor.alarms, in + 2, sizeof(sensor.alarms));
+
+    float previous = sensor.temperature;
+    sensor.temperature = temperature;
+    sensor.readTime = requestTime;
+    adapt(index, previous);
+    return true;
+}
+
+
+void TemperatureService::adapt(uint8_t index, float previous) {
+    Sensor &sensor = slots[index];
+    float temperature = sensor.temperature;
+    if (!adaptive || temperature == DEVICE_DISCONNECTED_C || sensor.address[0] == DS18S20MODEL)
+        return;
+
+    const Config &limits = config[index];
+    bool fast = previous != DEVICE_DISCONNECTED_C && fabs(temperature - previous) > fastChange;
+    bool near = temperature - limits.low < nearLimit || limits.high - temperature < nearLimit;
+    if (fast || near)
+        sensor.target = min(sensor.resolution + 1, constrain(limits.maxResolution, 9, 12));
+    else
+        sensor.target = 9;
+}
+
+
+bool TemperatureService::writeResolution() {
+    /* Queues one pending resolution change, false when there is none */
+    for (uint8_t i = 0; i < found; i++) {
+        Sensor &sensor = slots[i];
+        if (sensor.target == sensor.resolution)
+            continue;
+        // TH and TL as they were, the configuration byte is TEMP_9_BIT to TEMP_12_BIT
+        uint8_t length = select(i);
+        out[length++] = WRITE_SCRATCHPAD;
+        out[length++] = sensor.alarms[0];
+        out[length++] = sensor.alarms[1];
+        out[length++] = ((sensor.target - 9) << 5) | 0x1F;
+        submit(WRITE, ONEWIRE_RESET, length, 0);
+        return true;
+    }
+    return false;
+}
+
+
+bool TemperatureService::collect(unsigned long now) {
+    /* Takes the result of the exchange queued by an earlier call, true for
+       a new temperature */
+    Exchange finished = exchange;
+    exchange = NONE;
+
+    switch (finished) {
+        case CONVERT:
+            // The conversion started when the command ended, not when it was
+            // queued; counting from here is late by a poll period at most
+            requestTime = now;
+            pollTime = now;
+            return false;
+
+        case POLL:
+            allConverted = transaction.status == ONEWIRE_DONE && (in[0] & 1);
+            return false;
+
+        case READ:
+            return readDone();
+
+        case WRITE: {
+            Sensor &sensor = slots[exchangeSensor];
+            if (transaction.status == ONEWIRE_DONE)
+                sensor.resolution = sensor.target;
+            else
+                sensor.target = sensor.resolution;
+            return false;
+        }
+
+        default:
+            return false;
+    }
+}
+
+
+uint8_t TemperatureService::select(uint8_t index) {
+    /* Match ROM for one sensor into out, returns the bytes used */
+    out[0] = MATCH_ROM;
+    memcpy(out + 1, slots[index].address, sizeof(DeviceAddress));
+    exchangeSensor = index;
+    return 1 + sizeof(DeviceAddress);
+}
+
+
+bool TemperatureService::submit(Exchange next, uint8_t flags, uint8_t writeBytes, uint16_t readBits) {
+    /* Queues out and in as the transaction, false when the transport
+       takes none now; the caller tries again on a later call */
+    transaction.flags = flags;
+    transaction.writeBits = writeBytes * 8;
+    transaction.readBits = readBits;
+    if (!bus.submit(transaction))
+        return false;
+    exchange = next;
+    return true;
+}
@@ -0,0 +1,122 @@
+//
+// Created by rafal on 17.10.2026.
+//
+
+#ifndef ARDUINO_CAMPER_CONTROLLER_TEMPERATURESERVICE_H
+#define ARDUINO_CAMPER_CONTROLLER_TEMPERATURESERVICE_H
+
+#include <Arduino.h>
+
+#include "DallasTemperature/DallasTemperature.h"
+
+
+/* Reads a fixed set of sensors on one bus, each at its own period. A cycle
+   starts once any sensor is due: one broadcast conversion for the whole
+   bus, then each due sensor is read on the first update() call after its
+   own conversion time. Every exchange on the bus - the conversion, a
+   conversion poll, a scratchpad read, a resolution write - is one
+   OneWireTransaction queued on the bus transport, at most one per call.
+   A call that finds it still running returns at once, the next one after
+   it ended collects the result and queues what comes next. With the
+   Timer1 engine (ATmega328/168 and the host core) or the UART transport
+   no call waits on the bus; transports without interrupts run the
+   exchange inside submit(), so the call that queues it takes its bus
+   time, up to 12 ms for a read.
+
+   Resolution adapts to the readings. A sensor that moved more than
+   fastChange since its last reading, or is within nearLimit of its low or
+   high limit, goes up a bit per reading to its maxResolution. Otherwise
+   it drops straight to 9 bits, 94 ms instead of 750 ms at 12. The new
+   setting is written to the scratchpad only, between cycles; begin()
+   saves maxResolution to the EEPROM. A sensor that lost power comes back
+   at that, so a reading whose configuration byte does not match is
+   dropped and the sensor is read again in the next cycle. DS18S20s have
+   no setting and always take 750 ms.
+
+   The sensors take their slots in bus search order, which is fixed by
+   their ROM codes. Sensors past maxSensors are left alone, slots without a
+   sensor read DEVICE_DISCONNECTED_C. */
+class TemperatureService {
+public:
+    static const uint8_t maxSensors = 4;
+
+    struct Config {
+        uint8_t maxResolution;      // 9-12 bits
+        unsigned long period;       // ms
+        int8_t low;                 // C
+        int8_t high;                // C
+    };
+
+    TemperatureService(DallasTemperature &sensors, const Config *config, uint8_t count);
+    void begin();
+    bool update();
+
+    // Off keeps every sensor at its maxResolution, for comparisons
+    void setAdaptive(bool enabled);
+
+    uint8_t sensorCount() const;
+    float getTemperature(uint8_t sensor) const;
+    uint8_t getResolution(uint8_t sensor) const;
+    bool isConverting() const;
+
+private:
+    enum State {
+        IDLE,
+        CONVERTING
+    };
+
+    // What the queued transaction does
+    enum Exchange {
+        NONE,
+        CONVERT,
+        POLL,
+        READ,
+        WRITE
+    };
+
+    struct Sensor {
+        DeviceAddress address;
+        uint8_t resolution;
+        uint8_t target;             // written before the next cycle
+        unsigned int conversionTime;
+        unsigned long readTime;
+        float temperature;
+        uint8_t alarms[2];          // TH and TL, written back with the resolution
+    };
+
+    static const uint8_t pollInterval;
+    static const float fastChange;
+    static const float nearLimit;
+
+    DallasTemperature &sensors;
+    OneWireTransport &bus;
+    const Config *const config;
+    const uint8_t count;
+    Sensor slots[maxSensors];
+    uint8_t found = 0;
+    uint8_t due = 0;                // bit per sensor still to read in this cycle
+    uint8_t requested = 0;          // bit per sensor read in this cycle
+    bool adaptive = true;
+    bool allConverted = false;
+    State state = IDLE;
+    unsigned long requestTime = 0;
+    unsigned long pollTime = 0;
+
+    OneWireTransaction transaction;
+    Exchange exchange = NONE;
+    uint8_t exchangeSensor = 0;
+    uint8_t out[13];                // match ROM, write scratchpad, TH, TL, configuration
+    uint8_t in[9];                  // scratchpad
+
+    void requestConversion(uint8_t mask, unsigned long now);
+    bool conversionDone(unsigned long now);
+    void readNext(unsigned long now);
+    bool readDone();
+    void adapt(uint8_t index, float previous);
+    bool writeResolution();
+    bool collect(unsigned long now);
+    uint8_t select(uint8_t index);
+    bool submit(Exchange next, uint8_t flags, uint8_t writeBytes, uint16_t readBits);
+};
+
+#endif
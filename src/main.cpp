@@ -5,7 +5,18 @@
 #include "OneWire/OneWire.h"
 #include "DallasTemperature/DallasTemperature.h"
 
-#include "Button/Button.h"
+#include "ButtonGroup/ButtonGroup.h"
+#include "DoorMonitor/DoorMonitor.h"
+#include "AdcSampler/AdcSampler.h"
+#include "FixedPoint/FixedPoint.h"
+#include "CoulombCounter/CoulombCounter.h"
+#include "ChargeController/ChargeController.h"
+#include "AlarmTable/AlarmTable.h"
+#include "Scheduler/Scheduler.h"
+#include "PowerManager/PowerManager.h"
+#include "TemperatureService/TemperatureService.h"
+#include "LcdFrameBuffer/LcdFrameBuffer.h"
+#include "Profiler/Profiler.h"
 
 
 #define DOOR_SENSOR_1_PIN 5
@@ -13,6 +24,13 @@
 #define DOOR_SENSOR_3_PIN 3
 #define MENU_BUTTON_PIN 6
 
+// Door sensors and the menu button idle LOW and all sit on PORTD
+const byte DOOR_SENSOR_1 = bit(DOOR_SENSOR_1_PIN);
+const byte SIDE_DOOR_SENSORS = bit(DOOR_SENSOR_2_PIN) | bit(DOOR_SENSOR_3_PIN);
+const byte DOOR_SENSORS = DOOR_SENSOR_1 | SIDE_DOOR_SENSORS;
+const byte MENU_BUTTON = bit(MENU_BUTTON_PIN);
+const byte INPUT_TICK_TIME = 5; // 4 ticks to debounce
+
 #define ARMED_BLINK_LED_PIN 2
 #define ALARM_RELAY_PIN 1
 
@@ -20,12 +38,55 @@
 #define BATTERY_2_VOLTMETER_ANALOG_PIN A1
 #define BATTERY_2_AMMETER_ANALOG_PIN A2
 
+// Sampled in this order, indexes into AdcSampler::readSet()
+const byte ANALOG_PINS[] = {BATTERY_1_VOLTMETER_ANALOG_PIN, BATTERY_2_VOLTMETER_ANALOG_PIN, BATTERY_2_AMMETER_ANALOG_PIN};
+const byte BATTERY_1_VOLTAGE = 0;
+const byte BATTERY_2_VOLTAGE = 1;
+const byte BATTERY_2_CURRENT = 2;
+
 #define SECOND_BATTERY_RELAY_PIN 0
 
-const float SECOND_BATTERY_CHARGE_THRESHOLD = 14.00;
-const float VOLTAGE_CONVERTER_VALUE = 25.0; // Converter 0-25V --> 0-5V
-const float CONVERTER_SCALE_FACTOR = VOLTAGE_CONVERTER_VALUE / 5;
-const unsigned int SECOND_BATTERY_CHARGE_AFTER = 5000; // 60 seconds final !
+// The temperature sensors are on A3. The 1-Wire UART transport would need
+// pins 0 and 1, which drive the relays.
+#if ONEWIRE_UART
+#error "ONEWIRE_UART needs pins 0 and 1, they drive the relays on this board"
+#endif
+
+// Sensors in bus search order, i.e. sorted by ROM code. Label them by
+// their address when fitting new ones.
+const byte CABIN_TEMPERATURE = 0;
+const byte FRIDGE_TEMPERATURE = 1;
+const byte OUTSIDE_TEMPERATURE = 2;
+const byte BATTERY_BAY_TEMPERATURE = 3;
+// Resolution adapts up to the given one near the limits, C
+const TemperatureService::Config TEMPERATURE_SENSORS[] = {
+        {12, 15000, 5, 30},     // cabin, frost and heat
+        {11, 30000, 0, 8},      // fridge
+        {10, 60000, -5, 40},    // outside
+        {11, 30000, 0, 45}      // battery bay, charging limits
+};
+
+const uint32_t VOLTAGE_CONVERTER_VALUE = 25000; // Converter 0-25V --> 0-5V, mV
+const uint32_t CURRENT_CONVERTER_VALUE = 25000; // Same converter, 5V reads as 25A, mA
+constexpr uint16_t VOLTAGE_SCALE = fixedpoint::scale(VOLTAGE_CONVERTER_VALUE, AdcSampler::fullScale);
+constexpr uint16_t CURRENT_SCALE = fixedpoint::scale(CURRENT_CONVERTER_VALUE, AdcSampler::fullScale);
+
+// Second battery for the state of charge page, 100Ah at the 20h rate
+const unsigned long BATTERY_2_CAPACITY = 100000; // mAh
+const byte BATTERY_2_RATED_HOURS = 20;
+const byte BATTERY_2_PEUKERT = 125; // exponent * 100
+const byte BATTERY_2_CHARGE_EFFICIENCY = 90; // %
+const int BATTERY_2_SOC_EEPROM_ADDRESS = 0; // CoulombCounter::slotCount * slotSize bytes
+
+// Second battery relay, closed while the alternator runs
+const ChargeController::Config SECOND_BATTERY_CHARGE = {
+        14000,  // cut-in, mV
+        13300,  // cut-out, mV
+        5000,   // charge after, 60 seconds final !
+        30000,  // minimum on time
+        30000,  // minimum off time
+        100     // tick
+};
 
 const unsigned int ARMED_BLINK_TIME = 500;
 const unsigned int DISARMING_BLINK_TIME = 150;
@@ -34,9 +95,18 @@ const unsigned int ALARM_COUNTDOWN = 5000;
 const byte ALARM_RETRIES = 3;
 
 const unsigned long TIME_TO_UNLOCK = 5000; // How much time to unlock when front doors were opened
-const unsigned long TEMP_UPDATE_TIME = 15000; // 15s since its costly operation
+const unsigned int TEMP_POLL_TIME = 15; // one bus exchange per run, longer than a 12 ms scratchpad read
 const unsigned long LCD_BACKLIGHT_TIME = 15000;
 const unsigned long ANALOG_READ_TIME = 200;
+const unsigned int CONTROLLER_TIME = 10; // keypad and alarm, bounds the door event latency
+const unsigned int DISPLAY_TIME = 100;
+const unsigned int BACKLIGHT_CHECK_TIME = 100;
+
+// Build with LOOP_PROFILER=1 and send this character over Serial to get the
+// section timings. Serial shares pins 0 and 1 with the relays, so only turn
+// the profiler on for bench measurements. A character that arrives during
+// power-down is lost, send it again.
+const char PROFILE_DUMP_KEY = 'p';
 
 // Keyboard configuration
 const byte KEYPAD_ROWS = 4;
@@ -44,6 +114,11 @@ const byte KEYPAD_COLS = 3;
 
 byte rowPins[KEYPAD_ROWS] = {7, 8, 9, 10};
 byte colPins[KEYPAD_COLS] = {11, 12, 13};
+// Register level scan of the same pins, keep in sync with rowPins/colPins
+typedef PortScanner<PinList<7, 8, 9, 10>, PinList<11, 12, 13> > KeypadScanner;
+// Rows that wake the controller from power-down, row 7 on PORTD, 8-10 on PORTB
+const byte KEYPAD_WAKE_ROWS_B = bit(8 - 8) | bit(9 - 8) | bit(10 - 8);
+const byte KEYPAD_WAKE_ROWS_D = bit(7);
 
 char keyMap[KEYPAD_ROWS][KEYPAD_COLS] = {
         {'1','2','3'},
@@ -58,221 +133,365 @@ const char PIN_PASSPHRASE[] {'1', '2', '3', '4'};
 byte pinPosition;
 
 Keypad keypad = Keypad(makeKeymap(keyMap), rowPins, colPins, KEYPAD_ROWS, KEYPAD_COLS);
-Button menuButton(MENU_BUTTON_PIN, LOW);
-Button doorSensor1(DOOR_SENSOR_1_PIN, LOW);
-Button doorSensor2(DOOR_SENSOR_2_PIN, LOW);
-Button doorSensor3(DOOR_SENSOR_3_PIN, LOW);
+ButtonGroup inputs(MENU_BUTTON, MENU_BUTTON);
+DoorMonitor doors(DOOR_SENSORS);
+AdcSampler adc(ANALOG_PINS, sizeof(ANALOG_PINS));
+ChargeController charger(SECOND_BATTERY_RELAY_PIN, SECOND_BATTERY_CHARGE);
+CoulombCounter battery2Charge(BATTERY_2_CAPACITY, BATTERY_2_RATED_HOURS, BATTERY_2_PEUKERT,
+                              BATTERY_2_CHARGE_EFFICIENCY, BATTERY_2_SOC_EEPROM_ADDRESS);
 LiquidCrystal_I2C lcd(0x27, 16, 2);
+LcdFrameBuffer screen(lcd);
 OneWire oneWire(A3);
 DallasTemperature sensors(&oneWire);
+TemperatureService temperatureService(sensors, TEMPERATURE_SENSORS,
+                                      sizeof(TEMPERATURE_SENSORS) / sizeof(TEMPERATURE_SENSORS[0]));
 
-enum {
-    NORMAL = 1,
-    ARMED,
-    UNLOCKING,
-    ALARM
-} controllerState;
+constexpr Transition<AlarmTable::State, AlarmTable::Event> AlarmTable::transitions[];
+constexpr void (*AlarmTable::activities[])();
+StateMachine<AlarmTable> controller(AlarmTable::NORMAL);
 
 
-unsigned long currentTime;
+unsigned long currentTime; // Read at the start of each task
+unsigned long eventTime;
 unsigned long unlockTime;
 unsigned long blinkTime;
 unsigned long alarmTime;
 unsigned long countTime;
-unsigned long temperatureReadTime;
 unsigned long lcdBacklightTime;
-unsigned long analogReadTime;
-unsigned long secondBatteryChargeTime;
 
 byte menuPosition;
 char insertedKey;
 byte nAlarmRetries;
 
-bool isArming;
-bool passwordVerified;
-bool isCharging;
 bool screenTurnedOff;
 
-double temperature;
-double batteryVoltage1;
-double batteryVoltage2;
-double batteryCurrent2;
-
+uint16_t batteryVoltage1; // mV
+uint16_t batteryVoltage2; // mV
+uint16_t batteryCurrent2; // mA
+bool batteryMeasured;      // The values above come from a published ADC set
+
+PROFILE_SECTION(loopSection, "loop");
+PROFILE_SECTION(keypadSection, "keypad");
+PROFILE_SECTION(inputsSection, "inputs");
+PROFILE_SECTION(temperatureSection, "temperature");
+PROFILE_SECTION(analogSection, "analog");
+PROFILE_SECTION(lcdSection, "lcd");
+PROFILE_SECTION(controllerSection, "controller");
+
+void runController();
+void runInputs();
+void runTemperature();
+void runBacklight();
+void runAnalog();
+void runCharger();
+void runDisplay();
 void blinkPin(byte pinNum, unsigned int time);
-void countDown();
+void dispatchDoorEvents();
+bool canPowerDown();
+void powerDown();
 void stopBlinking();
-void disarmAlarm();
-void turnOnAlarm();
 void turnOffAlarm();
 bool checkPassword(char insertedChar);
 void printParam(const String &param, double value, byte row);
 void printParams(const String &param1, double value1, const String &param2, double value2);
+void printMilliParam(const String &param, long value, byte row, byte decimals = 2);
+void printIntParam(const String &param, long value, byte row);
+void printMilliParams(const String &param1, long value1, const String &param2, long value2);
 void keepInRange(byte &value, int min, int max);
+#if LOOP_PROFILER
+void dumpProfile();
+#endif
+
+
+// Every periodic job, run by the scheduler when due; budgets in us
+const char CONTROLLER_TASK[] PROGMEM = "controller";
+const char INPUTS_TASK[] PROGMEM = "inputs";
+const char ANALOG_TASK[] PROGMEM = "analog";
+const char CHARGER_TASK[] PROGMEM = "charger";
+const char TEMPERATURE_TASK[] PROGMEM = "temperature";
+const char DISPLAY_TASK[] PROGMEM = "display";
+const char BACKLIGHT_TASK[] PROGMEM = "backlight";
+
+Task tasks[] = {
+        {CONTROLLER_TASK, runController, CONTROLLER_TIME, 1000},
+        {INPUTS_TASK, runInputs, INPUT_TICK_TIME, 200},
+        {ANALOG_TASK, runAnalog, ANALOG_READ_TIME, 500},
+        {CHARGER_TASK, runCharger, SECOND_BATTERY_CHARGE.tickTime, 200},
+        {TEMPERATURE_TASK, runTemperature, TEMP_POLL_TIME, 1000},    // queues it, see TemperatureService
+        {DISPLAY_TASK, runDisplay, DISPLAY_TIME, 5000},
+        {BACKLIGHT_TASK, runBacklight, BACKLIGHT_CHECK_TIME, 500}
+};
+Scheduler scheduler(tasks, sizeof(tasks) / sizeof(tasks[0]));
+// Power-down while nobody is around: any door, the menu button or a key
+// wakes the controller within about a millisecond, otherwise the watchdog
+// every 250 ms. The 10 ms tasks then all run at once and count as late.
+PowerManager power(KEYPAD_WAKE_ROWS_B, KEYPAD_WAKE_ROWS_D | DOOR_SENSORS | MENU_BUTTON, colPins, KEYPAD_COLS);
 
 
 void setup() {
     pinMode(ARMED_BLINK_LED_PIN, OUTPUT);
     pinMode(ALARM_RELAY_PIN, OUTPUT);
-    pinMode(SECOND_BATTERY_RELAY_PIN, OUTPUT);
+    charger.begin(millis());
 
-    controllerState = NORMAL;
     pinPosition = 1;
-    isArming = false;
-    passwordVerified = false;
+    keypad.setMatrixScanner(KeypadScanner::scan);
+    keypad.beginBackgroundScan();
+    inputs.begin();
+    doors.begin();
+    adc.begin();
+    battery2Charge.begin(millis());
 
     lcd.begin();
     lcd.clear();
     lcd.home();
     screenTurnedOff = false;
 
-    isCharging = false;
-    sensors.begin();
+    temperatureService.begin();
+    scheduler.begin(millis());
+    power.begin();
 
+#if LOOP_PROFILER
+    Serial.begin(115200);
+#endif
 }
 
 void loop() {
+#if LOOP_PROFILER
+    if (Serial.available() && Serial.read() == PROFILE_DUMP_KEY)
+        dumpProfile();
+#endif
+    {
+        PROFILE_SCOPE(loopSection);
+        scheduler.runDue();
+    }
+    if (canPowerDown())
+        powerDown();
+    else
+        power.idle(scheduler);
+}
+
+
+bool canPowerDown() {
+    /* Backlight off, nothing counting down, no key held and no door event
+       waiting for the controller. The charger switches and times on the
+       battery voltage, it stays awake for that. Timer1 stops in power-down,
+       so no 1-Wire transaction may be queued. */
+    AlarmTable::State state = controller.state();
+    return screenTurnedOff && (state == AlarmTable::NORMAL || state == AlarmTable::ARMED)
+           && charger.getState() == ChargeController::IDLE && keypad.getState() == IDLE
+           && !doors.pending() && !power.settling() && oneWire.getEngine().idle();
+}
+
+void powerDown() {
+    adc.stop();
+    PowerManager::Wake wake = power.powerDown();
+    adc.begin();
+#if ADC_SAMPLER_ISR
+    // Fresh battery readings for the tasks about to run, about 5 ms
+    if (wake == PowerManager::WATCHDOG) {
+        byte sets = adc.sets();
+        while (adc.sets() == sets)
+            power.idle(scheduler);
+    }
+#else
+    (void) wake;
+#endif
+}
+
 
+void runController() {
     currentTime = millis();
-    insertedKey = keypad.getKey();
+    {
+        PROFILE_SCOPE(keypadSection);
+        insertedKey = keypad.getKey();
+    }
 
     if (insertedKey == RESET_PIN_KEY)
         pinPosition = 1;
 
-    if (menuButton.beenClicked()) {
-        lcd.clear();
+    // Events first, so a state entered now does its work in this run
+    PROFILE_SCOPE(controllerSection);
+    eventTime = currentTime;
+    controller.dispatch(AlarmTable::TICK);
+    dispatchDoorEvents();
+    if (insertedKey) {
+        eventTime = currentTime;
+        controller.dispatch(AlarmTable::KEY_PRESSED);
+    }
+    controller.run();
+}
+
+void runInputs() {
+    PROFILE_SCOPE(inputsSection);
+    currentTime = millis();
+    doors.poll();
+    inputs.update();
+    if (inputs.pressed() & MENU_BUTTON) {
         lcd.backlight();
         lcdBacklightTime = currentTime;
         if (screenTurnedOff) {
             screenTurnedOff = false;
         } else {
             menuPosition++;
-            keepInRange(menuPosition, 0, 2);
+            keepInRange(menuPosition, 0, 4);
         }
     }
+}
 
-    if (currentTime - temperatureReadTime >= TEMP_UPDATE_TIME) {
-        sensors.requestTemperatures();
-        temperature = sensors.getTempCByIndex(0);
-        temperatureReadTime = currentTime;
-    }
+void runTemperature() {
+    PROFILE_SCOPE(temperatureSection);
+    temperatureService.update();
+}
 
-    if (currentTime - lcdBacklightTime >= LCD_BACKLIGHT_TIME) {
+void runBacklight() {
+    currentTime = millis();
+    if (!screenTurnedOff && currentTime - lcdBacklightTime >= LCD_BACKLIGHT_TIME) {
         lcd.noBacklight();
         screenTurnedOff = true;
     }
+}
 
-    if (currentTime - analogReadTime >= ANALOG_READ_TIME) {
-        batteryVoltage1 = analogRead(BATTERY_1_VOLTMETER_ANALOG_PIN) * (5.0 / 1024.0) * CONVERTER_SCALE_FACTOR;
-        batteryVoltage2 = analogRead(BATTERY_2_VOLTMETER_ANALOG_PIN) * (5.0 / 1024.0) * CONVERTER_SCALE_FACTOR;
-        batteryCurrent2 = analogRead(BATTERY_2_AMMETER_ANALOG_PIN) * (5.0 / 1024.0) * CONVERTER_SCALE_FACTOR;
-        analogReadTime = currentTime;
-    }
-
-    if (batteryVoltage1 > SECOND_BATTERY_CHARGE_THRESHOLD && !isCharging) {
-        secondBatteryChargeTime = currentTime;
-        isCharging = true;
-    }
-
-    if (currentTime - secondBatteryChargeTime >= SECOND_BATTERY_CHARGE_AFTER && isCharging)
-        digitalWrite(SECOND_BATTERY_RELAY_PIN, HIGH);
-
-    if (batteryVoltage1 < SECOND_BATTERY_CHARGE_THRESHOLD) {
-        digitalWrite(SECOND_BATTERY_RELAY_PIN, LOW);
-        isCharging = false;
-    }
+void runAnalog() {
+    PROFILE_SCOPE(analogSection);
+    currentTime = millis();
+    adc.update();
+    // One set, so the current is paired with the voltages it was sampled with
+    uint16_t samples[sizeof(ANALOG_PINS)];
+    adc.readSet(samples);
+    batteryVoltage1 = fixedpoint::scaled(samples[BATTERY_1_VOLTAGE], VOLTAGE_SCALE);
+    batteryVoltage2 = fixedpoint::scaled(samples[BATTERY_2_VOLTAGE], VOLTAGE_SCALE);
+    batteryCurrent2 = fixedpoint::scaled(samples[BATTERY_2_CURRENT], CURRENT_SCALE);
+    // Current flows into the battery only while its relay is closed
+    battery2Charge.update(batteryCurrent2, charger.isCharging(), currentTime);
+    if (adc.sets())
+        batteryMeasured = true;
+}
 
+void runCharger() {
+    currentTime = millis();
+    /* Until the first set is published the voltage reads 0 mV, which would
+       prime the charger's filter far below cutIn */
+    if (batteryMeasured)
+        charger.update(batteryVoltage1, currentTime);
+}
 
+void runDisplay() {
+    PROFILE_SCOPE(lcdSection);
+    screen.clear();
     switch (menuPosition) {
         case 0:
-            printParams("Temp [C]", temperature, "Humidity", 62.7);
+            printParams("Cabin [C]", temperatureService.getTemperature(CABIN_TEMPERATURE),
+                        "Outside [C]", temperatureService.getTemperature(OUTSIDE_TEMPERATURE));
             break;
         case 1:
-            printParam("BAT 1 [V]", batteryVoltage1, 0);
+            printMilliParam("BAT 1 [V]", batteryVoltage1, 0);
             break;
         case 2:
-            printParams("BAT 2 [V]", batteryVoltage2, "BAT 2 [A]", batteryCurrent2);
+            printMilliParams("BAT 2 [V]", batteryVoltage2, "BAT 2 [A]", batteryCurrent2);
+            break;
+        case 3:
+            printIntParam("SoC 2 [%]", battery2Charge.percent(), 0);
+            printMilliParam("BAT 2 [Ah]", battery2Charge.remainingMah(), 1, 0);
+            break;
+        case 4:
+            printParams("Fridge [C]", temperatureService.getTemperature(FRIDGE_TEMPERATURE),
+                        "Bat bay [C]", temperatureService.getTemperature(BATTERY_BAY_TEMPERATURE));
             break;
         default:
-            lcd.clear();
             break;
     }
+    screen.flush();
+}
 
-    switch(controllerState) {
-        case NORMAL:
-            nAlarmRetries = 0;
-
-            // Stop counting down by pressing any key
-            if (isArming) {
-                countDown();
-                if (insertedKey) {
-                    isArming = false;
-                    break;
-                }
-            }
-            if (insertedKey == ARMING_KEY) {
-                isArming = true;
-                countTime = currentTime;
-            }
-            break;
 
-        case ARMED:
-            blinkPin(ARMED_BLINK_LED_PIN, ARMED_BLINK_TIME);
-            if (doorSensor2.beenClicked() || doorSensor2.isPressed() ||
-            doorSensor3.beenClicked() || doorSensor3.isPressed()) {
-                alarmTime = currentTime;
-                stopBlinking();
-                controllerState = ALARM;
-            } else if (doorSensor1.beenClicked()) {
-                unlockTime = currentTime;
-                controllerState = UNLOCKING;
-            }
-
-            if (insertedKey) {
-                passwordVerified = checkPassword(insertedKey);
-                if (passwordVerified)
-                    disarmAlarm();
-            }
-            break;
-
-        case UNLOCKING:
-            blinkPin(ARMED_BLINK_LED_PIN, DISARMING_BLINK_TIME);
-            if (insertedKey) {
-                passwordVerified = checkPassword(insertedKey);
-                if (passwordVerified)
-                    disarmAlarm();
-            }
-
-            if (currentTime - unlockTime >= TIME_TO_UNLOCK) {
-                alarmTime = currentTime;
-                controllerState = ALARM;
-            }
-            break;
+void dispatchDoorEvents() {
+    /* Edges latched by the door monitor since the last pass, timed when
+       they happened rather than when loop() got here. A side door still
+       open counts as well, e.g. after the siren stops. Events the current
+       state has no row for are dropped. */
+    DoorEvent event;
+    while (doors.read(event)) {
+        if (!event.open)
+            continue;
+        // An edge stamped after this run read the clock counts from then,
+        // so the guards' currentTime - eventTime cannot wrap
+        eventTime = (long) (event.time - currentTime) > 0 ? currentTime : event.time;
+        if (bitRead(SIDE_DOOR_SENSORS, event.pin))
+            controller.dispatch(AlarmTable::SIDE_DOOR_OPENED);
+        else if (bitRead(DOOR_SENSOR_1, event.pin))
+            controller.dispatch(AlarmTable::FRONT_DOOR_OPENED);
+    }
 
-        case ALARM:
-            if (nAlarmRetries < ALARM_RETRIES) {
-                stopBlinking();
-                turnOnAlarm();
-            } else
-                blinkPin(ARMED_BLINK_LED_PIN, DISARMING_BLINK_TIME);
-
-            if (insertedKey) {
-                passwordVerified = checkPassword(insertedKey);
-                if (passwordVerified) {
-                    turnOffAlarm();
-                    disarmAlarm();
-
-                }
-            }
-            break;
+    if (doors.openDoors() & SIDE_DOOR_SENSORS) {
+        eventTime = currentTime;
+        controller.dispatch(AlarmTable::SIDE_DOOR_OPENED);
     }
 }
 
 
-void countDown() {
-    if (currentTime - countTime >= ALARM_COUNTDOWN) {
-        controllerState = ARMED;
-        isArming = false;
-    }
+bool isArmingKey() {
+    return insertedKey == ARMING_KEY;
+}
+
+bool countdownElapsed() {
+    return currentTime - countTime >= ALARM_COUNTDOWN;
+}
+
+bool pinEntered() {
+    return checkPassword(insertedKey);
+}
+
+bool unlockTimeElapsed() {
+    return currentTime - unlockTime >= TIME_TO_UNLOCK;
+}
+
+bool alarmTimeElapsed() {
+    return nAlarmRetries < ALARM_RETRIES && currentTime - alarmTime >= ALARM_DURATION;
+}
+
+void startCountdown() {
+    countTime = eventTime;
+}
+
+void startAlarm() {
+    alarmTime = eventTime;
+    stopBlinking();
+}
+
+void startUnlocking() {
+    unlockTime = eventTime;
+}
+
+void disarmAlarm() {
+    turnOffAlarm();
+    stopBlinking();
+    pinPosition = 1;
+}
+
+void silenceAlarm() {
+    turnOffAlarm();
+    nAlarmRetries++;
+}
+
+void clearRetries() {
+    nAlarmRetries = 0;
+}
+
+void blinkArmed() {
+    blinkPin(ARMED_BLINK_LED_PIN, ARMED_BLINK_TIME);
+}
+
+void blinkUnlocking() {
+    blinkPin(ARMED_BLINK_LED_PIN, DISARMING_BLINK_TIME);
+}
+
+void soundAlarm() {
+    /* The siren gives up after ALARM_RETRIES rounds, the LED keeps going */
+    if (nAlarmRetries < ALARM_RETRIES) {
+        stopBlinking();
+        digitalWrite(ALARM_RELAY_PIN, HIGH);
+    } else
+        blinkPin(ARMED_BLINK_LED_PIN, DISARMING_BLINK_TIME);
 }
 
 void blinkPin(byte pinNum, unsigned int time) {
@@ -288,21 +507,6 @@ void stopBlinking() {
     digitalWrite(ARMED_BLINK_LED_PIN, LOW);
 }
 
-void disarmAlarm() {
-    stopBlinking();
-    controllerState = NORMAL;
-    pinPosition = 1;
-}
-
-void turnOnAlarm() {
-    digitalWrite(ALARM_RELAY_PIN, HIGH);
-    if (currentTime - alarmTime >= ALARM_DURATION) {
-        turnOffAlarm();
-        nAlarmRetries++;
-        controllerState = ARMED;
-    }
-}
-
 void turnOffAlarm() {
     digitalWrite(ALARM_RELAY_PIN, LOW);
 }
@@ -321,10 +525,10 @@ bool checkPassword(char insertedChar) {
 }
 
 void printParam(const String &param, double value, byte row) {
-    lcd.setCursor(0, row);
-    lcd.print(param);
-    lcd.setCursor(12, row);
-    lcd.print(value);
+    screen.setCursor(0, row);
+    screen.print(param);
+    screen.setCursor(12, row);
+    screen.print(value);
 }
 
 void printParams(const String &param1, double value1, const String &param2, double value2) {
@@ -332,9 +536,46 @@ void printParams(const String &param1, double value1, const String &param2, doub
     printParam(param2, value2, 1);
 }
 
+void printMilliParam(const String &param, long value, byte row, byte decimals) {
+    screen.setCursor(0, row);
+    screen.print(param);
+    screen.setCursor(12, row);
+    fixedpoint::print(screen, value, decimals);
+}
+
+void printIntParam(const String &param, long value, byte row) {
+    screen.setCursor(0, row);
+    screen.print(param);
+    screen.setCursor(12, row);
+    screen.print(value);
+}
+
+void printMilliParams(const String &param1, long value1, const String &param2, long value2) {
+    printMilliParam(param1, value1, 0);
+    printMilliParam(param2, value2, 1);
+}
+
 void keepInRange(byte &value, int min, int max) {
     if (value > max)
         value = min;
     if (value < min)
         value = max;
 }
+
+#if LOOP_PROFILER
+void dumpProfile() {
+    /* Prints and restarts the section and task timings and the LCD traffic */
+    ProfileSection::printAll(Serial);
+    scheduler.printStats(Serial);
+    power.printReport(Serial);
+    Serial.print(F("lcd bytes/frame max "));
+    Serial.print(screen.maxFrameBytes());
+    Serial.print(F(" avg "));
+    Serial.println((float) screen.totalBytes() / screen.frameCount());
+
+    ProfileSection::resetAll();
+    scheduler.resetStats();
+    power.resetReport();
+    screen.resetCounters();
+}
+#endif